@@ -0,0 +1,55 @@
+#include "document_service.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace
+{
+    constexpr int commands_per_document = 64;
+
+    // every document gets a stream of small edits with their undo records
+    void edit_documents(benchmark::State& state)
+    {
+        const auto document_count = static_cast<size_t>(state.range(0));
+        const auto threads = static_cast<size_t>(state.range(1));
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            auto service = std::make_unique<DocumentService>(threads, 64 * 1024);
+            std::vector<DocumentService::DocumentId> ids;
+            for (size_t i = 0; i < document_count; ++i)
+                ids.push_back(service->open("Lorem ipsum dolor sit amet"));
+            state.ResumeTiming();
+
+            for (int i = 0; i < commands_per_document; ++i)
+            {
+                for (auto id : ids)
+                {
+                    service->submit(id, [i](DocumentSession& session) {
+                        if (i % 4 == 3)
+                            session.history.undo();
+                        else if (i % 4 == 2)
+                            ToUpperCmd{session.document, session.history}.execute();
+                        else
+                            session.document.add_text(" consectetur");
+                    });
+                }
+            }
+            service->wait();
+
+            state.PauseTiming();
+            service.reset();
+            state.ResumeTiming();
+        }
+
+        state.SetItemsProcessed(state.iterations() * document_count * commands_per_document);
+    }
+} // namespace
+
+BENCHMARK(edit_documents)
+    ->ArgsProduct({{1'000, 10'000}, {1, 4}})
+    ->ArgNames({"documents", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -3,7 +3,10 @@
 #include "application.hpp"
 #include "mocks/mock_command.hpp"
 #include "mocks/mock_console.hpp"
+#include <chrono>
 #include <memory>
+#include <sstream>
+#include <thread>
 
 using namespace ::testing;
 
@@ -78,3 +81,112 @@ TEST_F(ApplicationTests_MainLoop, UnknownCommandPrintsErrorMesssage)
     
     app.run();
 }
+
+//-----------------------------------------------------------------
+
+struct ApplicationTests_Script : ApplicationTests_MainLoop
+{
+    std::shared_ptr<MockCommand> mq_other_cmd = std::make_shared<NiceMock<MockCommand>>();
+    ScriptConsole script_console{mq_console};
+    Document doc;
+    CommandHistory history;
+
+    ApplicationTests_Script()
+    {
+        app.add_command("other", mq_other_cmd);
+        app.add_command("AddText", std::make_shared<AddTextCmd>(doc, script_console, history));
+    }
+};
+
+TEST_F(ApplicationTests_Script, ExecutesCommandsInOrder)
+{
+    std::istringstream script{"cmd\n\n# comment\n  Other  \nCMD\n"};
+
+    InSequence seq;
+    EXPECT_CALL(*mq_cmd, execute());
+    EXPECT_CALL(*mq_other_cmd, execute());
+    EXPECT_CALL(*mq_cmd, execute());
+
+    app.run_script(script, script_console);
+}
+
+TEST_F(ApplicationTests_Script, DoesNotReadCommandsFromConsole)
+{
+    std::istringstream script{"cmd\n"};
+
+    EXPECT_CALL(mq_console, get_line()).Times(0);
+
+    app.run_script(script, script_console);
+}
+
+TEST_F(ApplicationTests_Script, ExitEndsScript)
+{
+    std::istringstream script{"cmd\nexit\nother\n"};
+
+    EXPECT_CALL(*mq_cmd, execute()).Times(1);
+    EXPECT_CALL(*mq_other_cmd, execute()).Times(0);
+
+    app.run_script(script, script_console);
+}
+
+TEST_F(ApplicationTests_Script, UnknownCommandRejectsWholeScript)
+{
+    std::istringstream script{"cmd\nunknown\n"};
+
+    EXPECT_CALL(*mq_cmd, execute()).Times(0);
+
+    ASSERT_THROW(app.run_script(script, script_console), std::invalid_argument);
+}
+
+TEST_F(ApplicationTests_Script, ReportsExecutionsPerCommand)
+{
+    std::istringstream script{"cmd\nother\ncmd\n"};
+
+    auto report = app.run_script(script, script_console);
+
+    ASSERT_EQ(report.executions, 3u);
+    ASSERT_EQ(report.commands.size(), 2u);
+    ASSERT_EQ(report.commands[0].name, "CMD");
+    ASSERT_EQ(report.commands[0].executions, 2u);
+    ASSERT_EQ(report.commands[1].name, "OTHER");
+    ASSERT_EQ(report.commands[1].executions, 1u);
+    ASSERT_EQ(report.commands[0].total_time + report.commands[1].total_time, report.total_time);
+}
+
+TEST_F(ApplicationTests_Script, FeedsRestOfLineToCommand)
+{
+    std::istringstream script{"AddText Hello World\n  addtext \t again \r\n"};
+
+    EXPECT_CALL(mq_console, get_line()).Times(0);
+
+    app.run_script(script, script_console);
+
+    ASSERT_EQ(doc.text(), "Hello Worldagain ");
+}
+
+TEST_F(ApplicationTests_Script, CommandWithoutArgumentReadsConsole)
+{
+    std::istringstream script{"cmd unread input\naddtext\n"};
+
+    EXPECT_CALL(mq_console, get_line()).WillOnce(Return("typed"));
+
+    app.run_script(script, script_console);
+
+    ASSERT_EQ(doc.text(), "typed");
+}
+
+TEST_F(ApplicationTests_Script, WaitForConsoleInputIsNotTimed)
+{
+    std::istringstream script{"addtext\n"};
+
+    EXPECT_CALL(mq_console, get_line()).WillOnce(Invoke([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return std::string{"typed"};
+    }));
+
+    auto report = app.run_script(script, script_console);
+
+    ASSERT_EQ(report.executions, 1u);
+    ASSERT_LT(report.total_time, std::chrono::milliseconds(100));
+    ASSERT_EQ(report.commands.back().total_time, report.total_time);
+}
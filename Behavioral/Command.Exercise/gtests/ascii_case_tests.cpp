@@ -0,0 +1,64 @@
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ascii_case.hpp"
+
+TEST(AsciiCase_Convert, ChangesOnlyAsciiLetters)
+{
+    std::string text = "Hello, World! 123 \xC3\xA9t\xC3\xA9";
+
+    AsciiCase::to_upper(text);
+    ASSERT_EQ(text, "HELLO, WORLD! 123 \xC3\xA9T\xC3\xA9");
+
+    AsciiCase::to_lower(text);
+    ASSERT_EQ(text, "hello, world! 123 \xC3\xA9t\xC3\xA9");
+}
+
+TEST(AsciiCase_Convert, MatchesStdToupperForAllBytes)
+{
+    std::string text;
+    for (int i = 0; i < 3; ++i)
+        for (int c = 0; c < 256; ++c)
+            text.push_back(static_cast<char>(c));
+
+    std::string expected = text;
+    for (auto& c : expected)
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+    AsciiCase::to_upper(text);
+
+    ASSERT_EQ(text, expected);
+}
+
+TEST(AsciiCase_FindChanges, ReturnsSpanOfChangedCharacters)
+{
+    const std::string text = std::string(100, 'X') + "a" + std::string(50, '.') + "b" + std::string(70, 'Y');
+
+    auto changes = AsciiCase::find_changes(text.data(), text.size(), true);
+
+    ASSERT_EQ(changes.first, 100u);
+    ASSERT_EQ(changes.last, 152u);
+}
+
+TEST(AsciiCase_FindChanges, IsEmptyWhenNothingChanges)
+{
+    const std::string text(130, 'X');
+
+    ASSERT_TRUE(AsciiCase::find_changes(text.data(), text.size(), true).empty());
+}
+
+TEST(AsciiCase_Revert, RestoresConvertedText)
+{
+    const std::string original = "The Quick Brown Fox jumps over 13 lazy DOGS - " + std::string(80, 'z');
+    std::string text = original;
+    std::vector<std::uint64_t> changed((text.size() + 63) / 64);
+
+    AsciiCase::convert(text.data(), text.size(), true, changed.data());
+    ASSERT_EQ(text, "THE QUICK BROWN FOX JUMPS OVER 13 LAZY DOGS - " + std::string(80, 'Z'));
+
+    AsciiCase::revert(text.data(), text.size(), changed.data());
+    ASSERT_EQ(text, original);
+}
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <stdexcept>
 
 #include <gtest/gtest.h>
 
@@ -67,6 +68,16 @@ TEST_F(ClearCmd_Undo, RestoresDocumentState)
     ASSERT_THAT(doc.text(), StrEq("abc"));
 }
 
+TEST_F(ClearCmd_Execute, UndoRestoresTextWithWhitespace)
+{
+    doc = Document{"first line\n  second line "};
+
+    clear_cmd.execute();
+    cmd_history.pop_last_command()->undo();
+
+    ASSERT_THAT(doc.text(), StrEq("first line\n  second line "));
+}
+
 //-----------------------------------------------------------------
 
 struct AddTextCmd_Execute : ReversibleCmdTests
@@ -149,6 +160,34 @@ TEST_F(ToUpperCmd_Undo, RestoresDocumentState)
     ASSERT_THAT(doc.text(), StrEq("abc"));
 }
 
+TEST_F(ToUpperCmd_Undo, RestoresOnlyChangedCharacters)
+{
+    doc = Document{"ABC def GhI 123"};
+
+    to_upper_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("ABC DEF GHI 123"));
+
+    cmd_history.pop_last_command()->undo();
+
+    ASSERT_THAT(doc.text(), StrEq("ABC def GhI 123"));
+}
+
+TEST_F(ToUpperCmd_Undo, UndoesCommandsInReverseOrder)
+{
+    doc = Document{"abc"};
+    ToUpperCmd to_upper{doc, cmd_history};
+    ClearCmd clear{doc, cmd_history};
+
+    to_upper.execute();
+    clear.execute();
+
+    cmd_history.pop_last_command()->undo();
+    ASSERT_THAT(doc.text(), StrEq("ABC"));
+
+    cmd_history.pop_last_command()->undo();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
 //-----------------------------------------------------------------
 
 struct PasteCmd_Execute : ReversibleCmdTests
@@ -213,4 +252,483 @@ TEST_F(UndoCmd_Execute, PopsLastCommandFromHistory)
     cmd_history.record_last_command(std::move(mq_cmd));
 
     undo_cmd.execute();
-}
\ No newline at end of file
+}
+//-----------------------------------------------------------------
+
+struct RedoCmd_Execute : CommandTests
+{
+    CommandHistory cmd_history;
+
+    UndoCmd undo_cmd{mq_console, cmd_history};
+    RedoCmd redo_cmd{mq_console, cmd_history};
+};
+
+TEST_F(RedoCmd_Execute, ReappliesUndoneCommand)
+{
+    ToUpperCmd to_upper{doc, cmd_history};
+
+    to_upper.execute();
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+
+    redo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("ABC"));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(RedoCmd_Execute, ReplaysCapturedInputWithoutAskingAgain)
+{
+    ON_CALL(mq_console, print(_)).WillByDefault(Return());
+    EXPECT_CALL(mq_console, get_line()).Times(1).WillOnce(Return("def"));
+
+    AddTextCmd add_text{doc, mq_console, cmd_history};
+    ClearCmd clear{doc, cmd_history};
+
+    add_text.execute();
+    clear.execute();
+    undo_cmd.execute();
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+
+    redo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+
+    redo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq(""));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+}
+
+TEST_F(RedoCmd_Execute, NewCommandClearsRedoStack)
+{
+    ToUpperCmd to_upper{doc, cmd_history};
+    ClearCmd clear{doc, cmd_history};
+
+    to_upper.execute();
+    undo_cmd.execute();
+    ASSERT_EQ(cmd_history.redo_count(), 1u);
+
+    clear.execute();
+    ASSERT_EQ(cmd_history.redo_count(), 0u);
+
+    EXPECT_CALL(mq_console, print("Nothing to redo.")).Times(1);
+    redo_cmd.execute();
+}
+
+//-----------------------------------------------------------------
+
+struct CommandHistory_MemoryBudget : CommandTests
+{
+    CommandHistory cmd_history{2 * sizeof(ClearCmd) + 10};
+};
+
+TEST_F(CommandHistory_MemoryBudget, DropsOldestCommandsWhenOverBudget)
+{
+    ClearCmd clear{doc, cmd_history};
+
+    clear.execute(); // keeps "abc"
+    doc = Document{"0123456789"};
+    clear.execute(); // keeps "0123456789" - the first one is dropped
+
+    ASSERT_EQ(cmd_history.undo_count(), 1u);
+    ASSERT_LE(cmd_history.memory_used(), cmd_history.memory_budget());
+
+    cmd_history.undo();
+    ASSERT_THAT(doc.text(), StrEq("0123456789"));
+    ASSERT_FALSE(cmd_history.undo());
+}
+
+TEST_F(CommandHistory_MemoryBudget, KeepsLastCommandEvenIfOverBudget)
+{
+    ClearCmd clear{doc, cmd_history};
+
+    doc = Document{std::string(1000, 'x')};
+    clear.execute();
+
+    ASSERT_EQ(cmd_history.undo_count(), 1u);
+
+    cmd_history.undo();
+    ASSERT_EQ(doc.length(), 1000u);
+}
+
+TEST_F(CommandHistory_MemoryBudget, TracksMemoryOfUndoAndRedoStacks)
+{
+    ToUpperCmd to_upper{doc, cmd_history};
+
+    to_upper.execute();
+    const size_t used = cmd_history.memory_used();
+    ASSERT_GT(used, 0u);
+
+    cmd_history.undo();
+    ASSERT_EQ(cmd_history.memory_used(), used);
+
+    ClearCmd clear{doc, cmd_history};
+    clear.execute();
+    ASSERT_EQ(cmd_history.memory_used(), sizeof(ClearCmd) + 3);
+}
+
+//-----------------------------------------------------------------
+
+struct MacroCmd_Execute : ReversibleCmdTests
+{
+    NiceMock<MockClipboard> mq_clipboard;
+    MacroCmd macro_cmd{doc, cmd_history};
+
+    void SetUp() override
+    {
+        ON_CALL(mq_clipboard, content()).WillByDefault(Return("def"));
+
+        macro_cmd.add(std::make_shared<PasteCmd>(doc, mq_clipboard, cmd_history))
+            .add(std::make_shared<ToUpperCmd>(doc, cmd_history))
+            .add(std::make_shared<PasteCmd>(doc, mq_clipboard, cmd_history));
+    }
+};
+
+TEST_F(MacroCmd_Execute, AppliesAllSteps)
+{
+    macro_cmd.execute();
+
+    ASSERT_THAT(doc.text(), StrEq("ABCDEFdef"));
+}
+
+TEST_F(MacroCmd_Execute, RecordsSingleHistoryEntry)
+{
+    macro_cmd.execute();
+
+    ASSERT_EQ(cmd_history.undo_count(), 1u);
+    ASSERT_EQ(typeid(*cmd_history.pop_last_command()), typeid(MacroCmd));
+}
+
+TEST_F(MacroCmd_Execute, UndoRevertsAllSteps)
+{
+    macro_cmd.execute();
+
+    cmd_history.undo();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+
+    cmd_history.redo();
+    ASSERT_THAT(doc.text(), StrEq("ABCDEFdef"));
+}
+
+TEST_F(MacroCmd_Execute, FailingStepRollsBackTransaction)
+{
+    auto failing_step = std::make_shared<MockReversibleCommand>();
+    EXPECT_CALL(*failing_step, execute()).WillOnce(Throw(std::runtime_error{"step failed"}));
+    macro_cmd.add(failing_step);
+
+    ASSERT_THROW(macro_cmd.execute(), std::runtime_error);
+
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+    ASSERT_EQ(cmd_history.undo_count(), 0u);
+}
+
+TEST_F(MacroCmd_Execute, KeepsStepsWhenExecutedTwice)
+{
+    macro_cmd.execute();
+    macro_cmd.execute();
+
+    ASSERT_EQ(macro_cmd.size(), 3u);
+    ASSERT_THAT(doc.text(), StrEq("ABCDEFDEFDEFdef"));
+    ASSERT_EQ(cmd_history.undo_count(), 2u);
+
+    cmd_history.undo();
+    ASSERT_THAT(doc.text(), StrEq("ABCDEFdef"));
+
+    cmd_history.undo();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(MacroCmd_Execute, MemoryFootprintCountsReplacedText)
+{
+    doc.restore(Rope{std::string(10'000, 'x')});
+
+    MacroCmd append{doc, cmd_history};
+    append.add(std::make_shared<PasteCmd>(doc, mq_clipboard, cmd_history));
+    append.execute();
+    const size_t used = cmd_history.memory_used();
+    ASSERT_LT(used, sizeof(MacroCmd) + 1000); // the unchanged text is shared with the document
+
+    MacroCmd clear{doc, cmd_history};
+    clear.add(std::make_shared<ClearCmd>(doc, cmd_history));
+    clear.execute();
+    ASSERT_GE(cmd_history.memory_used() - used, sizeof(MacroCmd) + 10'003); // the cleared text is owned by the history
+}
+
+//-----------------------------------------------------------------
+
+struct PasteCmd_SharedClipboard : ReversibleCmdTests
+{
+    SharedClipboard clipboard;
+    PasteCmd paste_cmd{doc, clipboard, cmd_history};
+};
+
+TEST_F(PasteCmd_SharedClipboard, PastesClipboardBufferWithoutCopy)
+{
+    clipboard.set_content(std::string(1000, 'x'));
+    const auto buffer = clipboard.snapshot();
+    const auto owners = buffer.use_count();
+
+    paste_cmd.execute();
+
+    ASSERT_EQ(doc.text(), "abc" + std::string(1000, 'x'));
+    ASSERT_GT(buffer.use_count(), owners); // shared by the document & the history
+}
+
+TEST_F(PasteCmd_SharedClipboard, LaterClipboardChangesDoNotAffectDocument)
+{
+    clipboard.set_content("def");
+    paste_cmd.execute();
+
+    clipboard.set_content("xyz");
+    cmd_history.undo();
+    cmd_history.redo();
+
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+}
+
+TEST(SharedClipboard_Snapshot, StaysValidAfterContentChanges)
+{
+    SharedClipboard clipboard;
+    clipboard.set_content("first");
+
+    auto snapshot = clipboard.snapshot();
+    clipboard.set_content("second");
+
+    ASSERT_EQ(*snapshot, "first");
+    ASSERT_EQ(clipboard.content(), "second");
+}
+
+//-----------------------------------------------------------------
+
+struct HistoryEntryTests : ReversibleCmdTests
+{
+    NiceMock<MockClipboard> mq_clipboard;
+};
+
+TEST_F(HistoryEntryTests, BuiltInCommandsAreStoredInline)
+{
+    ClearCmd clear{doc, cmd_history};
+    ToUpperCmd to_upper{doc, cmd_history};
+    AddTextCmd add_text{doc, mq_console, cmd_history};
+    PasteCmd paste{doc, mq_clipboard, cmd_history};
+    MacroCmd macro{doc, cmd_history};
+
+    ASSERT_TRUE(HistoryEntry{std::move(clear)}.is_inline());
+    ASSERT_TRUE(HistoryEntry{std::move(to_upper)}.is_inline());
+    ASSERT_TRUE(HistoryEntry{std::move(add_text)}.is_inline());
+    ASSERT_TRUE(HistoryEntry{std::move(paste)}.is_inline());
+    ASSERT_TRUE(HistoryEntry{std::move(macro)}.is_inline());
+}
+
+// undo state too large for a history entry
+class AppendBlockCmd : public ReversibleCommandBase<AppendBlockCmd>
+{
+public:
+    AppendBlockCmd(Document& doc, CommandHistory& history)
+        : ReversibleCommandBase{history}
+        , doc_{doc}
+    {
+    }
+
+protected:
+    void do_save_state() override
+    {
+        prev_length_ = doc_.length();
+    }
+
+    void do_execute() override
+    {
+        doc_.add_text(std::string(block_, block_ + sizeof(block_)));
+    }
+
+    void do_undo() override
+    {
+        doc_.replace(prev_length_, sizeof(block_), "");
+    }
+
+private:
+    Document& doc_;
+    size_t prev_length_{};
+    char block_[200] = {'x', 'y', 'z'};
+};
+
+TEST_F(HistoryEntryTests, LargeCommandSpillsToHeap)
+{
+    AppendBlockCmd append{doc, cmd_history};
+
+    ASSERT_FALSE(HistoryEntry{std::move(append)}.is_inline());
+}
+
+TEST_F(HistoryEntryTests, SpilledCommandCanBeUndoneAndRedone)
+{
+    AppendBlockCmd append{doc, cmd_history};
+    append.execute();
+    ASSERT_EQ(doc.length(), 203u);
+
+    cmd_history.undo();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+
+    cmd_history.redo();
+    ASSERT_EQ(doc.length(), 203u);
+}
+
+TEST_F(HistoryEntryTests, RingKeepsOrderWhenGrowingAndEvicting)
+{
+    CommandHistory history{40 * (sizeof(AddTextCmd) + 8)};
+    AddTextCmd add_text{doc, mq_console, history};
+
+    int line = 0;
+    ON_CALL(mq_console, get_line()).WillByDefault(Invoke([&line] { return std::to_string(line++ % 10); }));
+
+    for (int i = 0; i < 100; ++i)
+        add_text.execute();
+
+    ASSERT_LT(history.undo_count(), 100u);
+    const size_t kept = history.undo_count();
+
+    for (size_t i = 0; i < kept; ++i)
+        history.undo();
+
+    std::string expected = "abc";
+    for (size_t i = 0; i < 100 - kept; ++i)
+        expected += std::to_string(i % 10);
+    ASSERT_EQ(doc.text(), expected);
+}
+
+//-----------------------------------------------------------------
+
+// undo & redo fail while failing is set
+class FlakyAppendCmd : public ReversibleCommandBase<FlakyAppendCmd>
+{
+public:
+    FlakyAppendCmd(Document& doc, CommandHistory& history, const bool& failing)
+        : ReversibleCommandBase{history}
+        , doc_{doc}
+        , failing_{failing}
+    {
+    }
+
+protected:
+    void do_save_state() override
+    {
+        prev_length_ = doc_.length();
+    }
+
+    void do_execute() override
+    {
+        doc_.add_text("!");
+    }
+
+    void do_undo() override
+    {
+        if (failing_)
+            throw std::runtime_error("undo failed");
+
+        doc_.replace(prev_length_, 1, "");
+    }
+
+    void do_redo() override
+    {
+        if (failing_)
+            throw std::runtime_error("redo failed");
+
+        do_execute();
+    }
+
+private:
+    Document& doc_;
+    const bool& failing_;
+    size_t prev_length_{};
+};
+
+struct CommandHistory_Failure : ReversibleCmdTests
+{
+    bool failing = false;
+    FlakyAppendCmd append{doc, cmd_history, failing};
+};
+
+TEST_F(CommandHistory_Failure, CommandStaysUndoableWhenUndoThrows)
+{
+    append.execute();
+    const size_t used = cmd_history.memory_used();
+
+    failing = true;
+    ASSERT_THROW(cmd_history.undo(), std::runtime_error);
+    ASSERT_EQ(cmd_history.undo_count(), 1u);
+    ASSERT_EQ(cmd_history.redo_count(), 0u);
+    ASSERT_EQ(cmd_history.memory_used(), used);
+
+    failing = false;
+    ASSERT_TRUE(cmd_history.undo());
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(CommandHistory_Failure, CommandStaysRedoableWhenRedoThrows)
+{
+    append.execute();
+    cmd_history.undo();
+
+    failing = true;
+    ASSERT_THROW(cmd_history.redo(), std::runtime_error);
+    ASSERT_EQ(cmd_history.undo_count(), 0u);
+    ASSERT_EQ(cmd_history.redo_count(), 1u);
+
+    failing = false;
+    ASSERT_TRUE(cmd_history.redo());
+    ASSERT_THAT(doc.text(), StrEq("abc!"));
+}
+
+//-----------------------------------------------------------------
+
+// commands registered once in Application are executed many times - moving the undo
+// state into the history must leave them ready for the next execution
+struct ReversibleCmd_ExecutedTwice : ReversibleCmdTests
+{
+    NiceMock<MockClipboard> mq_clipboard;
+
+    template <typename Cmd>
+    void execute_twice_and_undo(Cmd& cmd, const std::string& expected_after_first, const std::string& expected_after_second)
+    {
+        cmd.execute();
+        ASSERT_EQ(doc.text(), expected_after_first);
+        cmd.execute();
+        ASSERT_EQ(doc.text(), expected_after_second);
+        ASSERT_EQ(cmd_history.undo_count(), 2u);
+
+        cmd_history.undo();
+        ASSERT_EQ(doc.text(), expected_after_first);
+        cmd_history.undo();
+        ASSERT_EQ(doc.text(), "abc");
+    }
+};
+
+TEST_F(ReversibleCmd_ExecutedTwice, ClearCmd)
+{
+    ClearCmd clear{doc, cmd_history};
+    execute_twice_and_undo(clear, "", "");
+}
+
+TEST_F(ReversibleCmd_ExecutedTwice, ToUpperCmd)
+{
+    ToUpperCmd to_upper{doc, cmd_history};
+    execute_twice_and_undo(to_upper, "ABC", "ABC");
+}
+
+TEST_F(ReversibleCmd_ExecutedTwice, AddTextCmd)
+{
+    AddTextCmd add_text{doc, mq_console, cmd_history};
+    EXPECT_CALL(mq_console, get_line()).WillOnce(Return("def")).WillOnce(Return("ghi"));
+
+    execute_twice_and_undo(add_text, "abcdef", "abcdefghi");
+}
+
+TEST_F(ReversibleCmd_ExecutedTwice, PasteCmd)
+{
+    PasteCmd paste{doc, mq_clipboard, cmd_history};
+    EXPECT_CALL(mq_clipboard, content()).WillRepeatedly(Return("xy"));
+
+    execute_twice_and_undo(paste, "abcxy", "abcxyxy");
+}
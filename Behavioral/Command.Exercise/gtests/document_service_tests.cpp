@@ -0,0 +1,77 @@
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "document_service.hpp"
+
+using namespace ::testing;
+
+struct DocumentServiceTests : ::testing::Test
+{
+    DocumentService service{4};
+};
+
+TEST_F(DocumentServiceTests, OpensDocumentsWithText)
+{
+    auto first = service.open("abc");
+    auto second = service.open();
+
+    ASSERT_EQ(service.size(), 2u);
+    ASSERT_EQ(service.submit(first, [](DocumentSession& s) { return s.document.text(); }).get(), "abc");
+    ASSERT_EQ(service.submit(second, [](DocumentSession& s) { return s.document.text(); }).get(), "");
+}
+
+TEST_F(DocumentServiceTests, CommandsForOneDocumentRunInOrder)
+{
+    auto id = service.open();
+
+    for (int i = 0; i < 1000; ++i)
+        service.submit(id, [i](DocumentSession& s) { s.document.add_text(std::to_string(i) + ","); });
+
+    std::string expected;
+    for (int i = 0; i < 1000; ++i)
+        expected += std::to_string(i) + ",";
+
+    ASSERT_EQ(service.submit(id, [](DocumentSession& s) { return s.document.text(); }).get(), expected);
+}
+
+TEST_F(DocumentServiceTests, EachDocumentHasItsOwnHistory)
+{
+    std::vector<DocumentService::DocumentId> ids;
+    for (int i = 0; i < 100; ++i)
+        ids.push_back(service.open("doc" + std::to_string(i)));
+
+    for (auto id : ids)
+    {
+        service.submit(id, [](DocumentSession& s) { ToUpperCmd{s.document, s.history}.execute(); });
+        service.submit(id, [](DocumentSession& s) { ClearCmd{s.document, s.history}.execute(); });
+        service.submit(id, [](DocumentSession& s) { s.history.undo(); });
+    }
+    service.wait();
+
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        auto [text, undo_count] = service.submit(ids[i], [](DocumentSession& s) {
+            return std::pair{s.document.text(), s.history.undo_count()};
+        }).get();
+
+        ASSERT_EQ(text, "DOC" + std::to_string(i));
+        ASSERT_EQ(undo_count, 1u);
+    }
+}
+
+TEST_F(DocumentServiceTests, ExceptionIsPassedToFuture)
+{
+    auto id = service.open();
+
+    auto result = service.submit(id, [](DocumentSession& s) { s.document.replace(10, 1, "x"); });
+
+    ASSERT_THROW(result.get(), std::out_of_range);
+}
+
+TEST_F(DocumentServiceTests, UnknownDocumentThrows)
+{
+    ASSERT_THROW(service.submit(7, [](DocumentSession&) {}), std::out_of_range);
+}
@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -6,6 +8,7 @@
 #include "document.hpp"
 
 using namespace ::testing;
+using namespace std::literals;
 
 struct DocumentTests : ::testing::Test
 {
@@ -52,6 +55,40 @@ TEST_F(Document_Clear, TextIsCleared)
     ASSERT_THAT(doc.text(), IsEmpty());
 }
 
+struct Document_Snapshot : Document_ValueConstructed
+{
+};
+
+TEST_F(Document_Snapshot, IsNotAffectedByLaterEdits)
+{
+    auto snapshot = doc.snapshot();
+
+    doc.add_text("def");
+    doc.replace(0, 1, "x");
+
+    ASSERT_THAT(snapshot.str(), StrEq("abc"));
+}
+
+TEST_F(Document_Snapshot, RestoresThePreviousState)
+{
+    auto snapshot = doc.snapshot();
+    doc.clear();
+
+    doc.restore(snapshot);
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(Document_Snapshot, ChunksConcatenateToText)
+{
+    doc.add_text("def");
+    doc.replace(1, 1, "XYZ");
+
+    std::string chunks;
+    doc.for_each_chunk([&](std::string_view chunk) { chunks += chunk; });
+
+    ASSERT_THAT(chunks, StrEq(doc.text()));
+}
+
 struct Document_AddText : Document_ValueConstructed
 {
 };
@@ -82,6 +119,46 @@ TEST_F(Document_CaseConversion, ToLowerCase)
     ASSERT_THAT(doc.text(), StrEq("abcdef"));
 }
 
+TEST_F(Document_CaseConversion, RevertUndoesToUpper)
+{
+    auto change = doc.to_upper();
+    doc.revert(change);
+
+    ASSERT_THAT(doc.text(), StrEq("abcDEF"));
+}
+
+TEST_F(Document_CaseConversion, RevertUndoesToLower)
+{
+    auto change = doc.to_lower();
+    doc.revert(change);
+
+    ASSERT_THAT(doc.text(), StrEq("abcDEF"));
+}
+
+TEST_F(Document_CaseConversion, RevertOfLongTextRestoresEveryPosition)
+{
+    std::string text;
+    for (int i = 0; i < 1000; ++i)
+        text += (i % 3 == 0) ? 'x' : (i % 3 == 1 ? 'Y' : '.');
+    doc = Document{text};
+
+    auto change = doc.to_upper();
+    ASSERT_THAT(doc.text(), Not(HasSubstr("x")));
+
+    doc.revert(change);
+    ASSERT_THAT(doc.text(), StrEq(text));
+}
+
+TEST_F(Document_CaseConversion, RevertOfUnchangedTextDoesNothing)
+{
+    doc = Document{"ABC 123"};
+
+    auto change = doc.to_upper();
+    doc.revert(change);
+
+    ASSERT_THAT(doc.text(), StrEq("ABC 123"));
+}
+
 struct Document_ReplacingText : Document_ValueConstructed
 {
 };
@@ -104,4 +181,54 @@ TEST_F(Document_Memento, RestoresThePreviousState)
     doc.set_memento(snapshot);
 
     ASSERT_THAT(doc.text(), StrEq("abc"));
-}
\ No newline at end of file
+}
+TEST_F(Document_Memento, BinaryRoundTripKeepsWhitespace)
+{
+    const std::string text = "first line\n  second\tline \0 end"s;
+    doc = Document{text};
+
+    auto snapshot = doc.create_memento();
+    doc.clear();
+    doc.set_memento(snapshot);
+
+    ASSERT_EQ(doc.text(), text);
+}
+
+TEST_F(Document_Memento, StreamSerializersStillPlugIn)
+{
+    auto snapshot = doc.create_memento<StreamOutputSerializer>();
+    doc.clear();
+    doc.set_memento<StreamInputSerializer>(snapshot);
+
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST(BinarySerializers, RoundTripStringsAndValues)
+{
+    std::vector<char> buffer;
+    BinaryOutputSerializer out{buffer};
+    ASSERT_TRUE(out(std::string{"a b\nc"}, 42, 3.5));
+
+    std::string text;
+    int number{};
+    double value{};
+    BinaryInputSerializer in{buffer};
+    ASSERT_TRUE(in(text, number, value));
+
+    ASSERT_EQ(text, "a b\nc");
+    ASSERT_EQ(number, 42);
+    ASSERT_EQ(value, 3.5);
+}
+
+TEST(BinarySerializers, TruncatedBufferFailsToRead)
+{
+    std::string buffer;
+    BinaryOutputSerializer out{buffer};
+    out(std::string{"abcdef"});
+    buffer.pop_back();
+
+    std::string text;
+    BinaryInputSerializer in{buffer};
+
+    ASSERT_FALSE(in(text));
+}
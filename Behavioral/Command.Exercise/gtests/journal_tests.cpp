@@ -0,0 +1,259 @@
+#include <filesystem>
+#include <fstream>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "command.hpp"
+#include "journal.hpp"
+#include "mocks/mock_console.hpp"
+
+using namespace ::testing;
+
+struct JournalTests : ::testing::Test
+{
+    std::filesystem::path directory;
+    std::string path;
+
+    JournalTests()
+    {
+        directory = std::filesystem::temp_directory_path() / ("journal_tests_" + std::to_string(::getpid()) + "_"
+                        + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        path = (directory / "document.journal").string();
+    }
+
+    ~JournalTests() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::string recovered_text(RecoveryInfo* info = nullptr)
+    {
+        Document doc;
+        auto recovery = DocumentJournal::recover(path, doc);
+        if (info)
+            *info = recovery;
+        return doc.text();
+    }
+};
+
+TEST_F(JournalTests, MissingJournalRecoversEmptyDocument)
+{
+    RecoveryInfo info;
+
+    ASSERT_EQ(recovered_text(&info), "");
+    ASSERT_FALSE(info.snapshot_loaded);
+    ASSERT_EQ(info.replayed_records, 0u);
+}
+
+TEST_F(JournalTests, RecoversEditsOfCommandsAndUndo)
+{
+    {
+        Document doc;
+        DocumentJournal journal{path, doc};
+        CommandHistory history;
+        NiceMock<MockConsole> console;
+        ON_CALL(console, get_line()).WillByDefault(Return("Hello World"));
+
+        AddTextCmd{doc, console, history}.execute();
+        ToUpperCmd{doc, history}.execute();
+        history.undo();
+        doc.add_text("!");
+        ClearCmd{doc, history}.execute();
+        history.undo();
+        doc.replace(0, 5, "Goodbye");
+        doc.to_lower();
+        ToUpperCmd{doc, history}.execute();
+        history.undo();
+        history.redo();
+    }
+
+    RecoveryInfo info;
+    ASSERT_EQ(recovered_text(&info), "GOODBYE WORLD!");
+    ASSERT_FALSE(info.torn_tail);
+}
+
+TEST_F(JournalTests, ContinuesJournalAfterRecovery)
+{
+    {
+        Document doc;
+        DocumentJournal journal{path, doc};
+        doc.add_text("abc");
+    }
+
+    {
+        Document doc;
+        DocumentJournal journal{path, doc};
+        ASSERT_EQ(doc.text(), "abc");
+        ASSERT_EQ(journal.recovery_info().replayed_records, 1u);
+
+        doc.add_text("def");
+    }
+
+    ASSERT_EQ(recovered_text(), "abcdef");
+}
+
+TEST_F(JournalTests, TornTailIsIgnored)
+{
+    {
+        Document doc;
+        DocumentJournal journal{path, doc};
+        doc.add_text("abc");
+        doc.add_text("def");
+    }
+
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 2); // the last record is cut in the middle
+
+    RecoveryInfo info;
+    ASSERT_EQ(recovered_text(&info), "abc");
+    ASSERT_TRUE(info.torn_tail);
+
+    {
+        Document doc;
+        DocumentJournal journal{path, doc};
+        doc.add_text("xyz");
+    }
+
+    ASSERT_EQ(recovered_text(&info), "abcxyz");
+    ASSERT_FALSE(info.torn_tail);
+}
+
+TEST_F(JournalTests, CorruptedLastRecordIsIgnored)
+{
+    {
+        Document doc;
+        DocumentJournal journal{path, doc};
+        doc.add_text("abc");
+        doc.add_text("def");
+    }
+
+    {
+        std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+        file.seekp(-1, std::ios::end);
+        file.put('X');
+    }
+
+    RecoveryInfo info;
+    ASSERT_EQ(recovered_text(&info), "abc");
+    ASSERT_TRUE(info.torn_tail);
+}
+
+TEST_F(JournalTests, SnapshotsBoundReplay)
+{
+    JournalOptions options;
+    options.snapshot_interval = 10;
+
+    {
+        Document doc;
+        DocumentJournal journal{path, doc, options};
+        for (int i = 0; i < 25; ++i)
+            doc.add_text(std::to_string(i));
+    }
+
+    std::string expected;
+    for (int i = 0; i < 25; ++i)
+        expected += std::to_string(i);
+
+    RecoveryInfo info;
+    ASSERT_EQ(recovered_text(&info), expected);
+    ASSERT_TRUE(info.snapshot_loaded);
+    ASSERT_EQ(info.replayed_records, 5u);
+}
+
+TEST_F(JournalTests, RestoresAreSnapshotsNotCopiesOfTheText)
+{
+    const std::string text(1 << 20, 'x');
+
+    {
+        Document doc;
+        DocumentJournal journal{path, doc};
+        CommandHistory history;
+        ClearCmd clear{doc, history};
+
+        doc.add_text(text);
+        for (int i = 0; i < 20; ++i)
+        {
+            clear.execute();
+            history.undo();
+        }
+        doc.add_text("!");
+
+        journal.commit();
+        ASSERT_LT(std::filesystem::file_size(path), 1024u);
+    }
+
+    RecoveryInfo info;
+    ASSERT_EQ(recovered_text(&info), text + "!");
+    ASSERT_TRUE(info.snapshot_loaded);
+    ASSERT_EQ(info.replayed_records, 1u);
+}
+
+TEST_F(JournalTests, CommitMakesEditsDurable)
+{
+    Document doc;
+    DocumentJournal journal{path, doc};
+    doc.add_text("abc");
+
+    journal.commit();
+
+    ASSERT_EQ(recovered_text(), "abc");
+}
+
+TEST_F(JournalTests, AssignedDocumentStaysJournaled)
+{
+    {
+        Document doc;
+        DocumentJournal journal{path, doc};
+        doc.add_text("abc");
+
+        doc = Document{"xyz"};
+        doc.add_text("!");
+    }
+
+    ASSERT_EQ(recovered_text(), "xyz!");
+}
+
+TEST_F(JournalTests, CopyOfDocumentIsNotJournaled)
+{
+    {
+        Document doc;
+        DocumentJournal journal{path, doc};
+        doc.add_text("abc");
+
+        Document copy = doc;
+        copy.add_text("def");
+        Document moved = std::move(copy);
+        moved.clear();
+    }
+
+    ASSERT_EQ(recovered_text(), "abc");
+}
+
+TEST_F(JournalTests, IoErrorIsReportedByCommitNotByEdits)
+{
+    JournalOptions options;
+    options.snapshot_interval = 2;
+
+    Document doc;
+    DocumentJournal journal{path, doc, options};
+    CommandHistory history;
+
+    std::filesystem::create_directory(path + ".snapshot"); // the snapshot cannot be renamed over it
+
+    doc.add_text("abc");
+    ASSERT_NO_THROW(doc.add_text("def")); // requests the snapshot
+
+    ASSERT_THROW(journal.commit(), std::runtime_error);
+    ASSERT_TRUE(journal.error());
+
+    ClearCmd clear{doc, history};
+    ASSERT_NO_THROW(clear.execute());
+    ASSERT_EQ(history.undo_count(), 1u);
+
+    history.undo();
+    ASSERT_EQ(doc.text(), "abcdef");
+}
@@ -0,0 +1,183 @@
+#include <memory>
+#include <random>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "rope.hpp"
+
+using namespace ::testing;
+
+struct Rope_Empty : Test
+{
+    Rope rope;
+};
+
+TEST_F(Rope_Empty, HasNoText)
+{
+    ASSERT_TRUE(rope.empty());
+    ASSERT_THAT(rope.size(), Eq(0));
+    ASSERT_THAT(rope.str(), IsEmpty());
+}
+
+TEST_F(Rope_Empty, InsertBeyondEndThrows)
+{
+    ASSERT_THROW(rope.insert(1, "abc"), std::out_of_range);
+}
+
+struct Rope_Editing : Test
+{
+    Rope rope{"Hello world"};
+};
+
+TEST_F(Rope_Editing, InsertsInTheMiddle)
+{
+    rope.insert(5, ",");
+
+    ASSERT_THAT(rope.str(), StrEq("Hello, world"));
+}
+
+TEST_F(Rope_Editing, ErasesRange)
+{
+    rope.erase(5, 6);
+
+    ASSERT_THAT(rope.str(), StrEq("Hello"));
+}
+
+TEST_F(Rope_Editing, EraseIsClippedToTheEnd)
+{
+    rope.erase(5, 100);
+
+    ASSERT_THAT(rope.str(), StrEq("Hello"));
+}
+
+TEST_F(Rope_Editing, ReplacesRange)
+{
+    rope.replace(6, 5, "rope");
+
+    ASSERT_THAT(rope.str(), StrEq("Hello rope"));
+}
+
+TEST_F(Rope_Editing, SubstrSpansPieces)
+{
+    rope.append(std::string(1000, '!'));
+    rope.insert(3, std::string(500, '#'));
+
+    ASSERT_THAT(rope.substr(0, 4), StrEq("Hel#"));
+    ASSERT_THAT(rope.substr(502, 4), StrEq("#lo "));
+}
+
+TEST_F(Rope_Editing, CopiesAreIndependent)
+{
+    Rope copy = rope;
+
+    rope.replace(0, 5, "Bye");
+    copy.append("!");
+
+    ASSERT_THAT(rope.str(), StrEq("Bye world"));
+    ASSERT_THAT(copy.str(), StrEq("Hello world!"));
+}
+
+TEST(Rope_RandomEdits, MatchStdString)
+{
+    std::mt19937 rnd_gen{42};
+    Rope rope;
+    std::string expected;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        const size_t pos = std::uniform_int_distribution<size_t>{0, expected.size()}(rnd_gen);
+        const size_t count = std::uniform_int_distribution<size_t>{0, 20}(rnd_gen);
+        const std::string text(std::uniform_int_distribution<size_t>{0, 300}(rnd_gen), static_cast<char>('a' + i % 26));
+
+        switch (i % 3)
+        {
+        case 0:
+            rope.insert(pos, text);
+            expected.insert(pos, text);
+            break;
+        case 1:
+            rope.erase(pos, count);
+            expected.erase(pos, count);
+            break;
+        default:
+            rope.replace(pos, count, text);
+            expected.replace(pos, count, text);
+            break;
+        }
+
+        ASSERT_THAT(rope.size(), Eq(expected.size()));
+    }
+
+    ASSERT_THAT(rope.str(), StrEq(expected));
+
+    std::string chunks;
+    rope.for_each_chunk([&](std::string_view chunk) { chunks += chunk; });
+    ASSERT_THAT(chunks, StrEq(expected));
+}
+
+TEST(Rope_SharedBuffer, LargeBufferIsSharedNotCopied)
+{
+    auto buffer = std::make_shared<const std::string>(1000, 'x');
+    Rope rope{"abc"};
+
+    rope.insert(1, buffer);
+
+    ASSERT_GT(buffer.use_count(), 1);
+    ASSERT_EQ(rope.str(), "a" + std::string(1000, 'x') + "bc");
+}
+
+TEST(Rope_SharedBuffer, ShortBufferIsCopied)
+{
+    auto buffer = std::make_shared<const std::string>("def");
+    Rope rope{"abc"};
+
+    rope.append(buffer);
+
+    ASSERT_EQ(buffer.use_count(), 1);
+    ASSERT_EQ(rope.str(), "abcdef");
+}
+
+struct Rope_DifferenceSize : Test
+{
+    Rope rope;
+
+    void SetUp() override
+    {
+        for (int i = 0; i < 100; ++i)
+            rope.append(std::string(300, 'a' + i % 26));
+    }
+};
+
+TEST_F(Rope_DifferenceSize, CopiesShareAllText)
+{
+    const Rope copy = rope;
+
+    ASSERT_EQ(rope.difference_size(copy), 0u);
+}
+
+TEST_F(Rope_DifferenceSize, CountsOnlyAppendedText)
+{
+    Rope edited = rope;
+    edited.append(std::string(500, 'z'));
+
+    ASSERT_EQ(rope.difference_size(edited), 500u);
+    ASSERT_EQ(edited.difference_size(rope), 500u);
+}
+
+TEST_F(Rope_DifferenceSize, CountsErasedText)
+{
+    Rope edited = rope;
+    edited.erase(0, rope.size());
+
+    ASSERT_EQ(rope.difference_size(edited), rope.size());
+}
+
+TEST_F(Rope_DifferenceSize, CountsCutPiecesOfBothRopes)
+{
+    Rope edited = rope;
+    edited.insert(450, std::string(500, 'z')); // cuts the second piece
+
+    ASSERT_EQ(rope.difference_size(edited), 300u + 300u + 500u);
+}
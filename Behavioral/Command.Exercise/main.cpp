@@ -1,26 +1,66 @@
 #include "application.hpp"
 #include "command.hpp"
+#include "journal.hpp"
 
+#include <cstring>
+#include <fstream>
 #include <iostream>
 
 using namespace std;
 
-int main()
+int main(int argc, char* argv[])
 {
     Document doc;
     Terminal terminal;
+    ScriptConsole console{terminal}; // a script feeds the input of its commands
     SharedClipboard shared_clipboard;
-    CommandHistory cmd_history;
+    CommandHistory cmd_history{64 * 1024 * 1024}; // undo & redo may keep up to 64 MB
 
-    Application app(terminal);
-    app.add_command("Print"s, std::make_shared<PrintCmd>(doc, terminal));
+    // edits of the previous session are recovered - the undo history is not
+    DocumentJournal journal{"document.journal", doc};
+    if (journal.recovery_info().snapshot_loaded || journal.recovery_info().replayed_records > 0)
+        terminal.print("Recovered document: [" + doc.text() + "]");
+
+    Application app(console);
+    app.add_command("Print"s, std::make_shared<PrintCmd>(doc, console));
     app.add_command("ToUpper"s, std::make_shared<ToUpperCmd>(doc, cmd_history));
     app.add_command("Clear"s, std::make_shared<ClearCmd>(doc, cmd_history));
-    app.add_command("AddText"s, std::make_shared<AddTextCmd>(doc, terminal, cmd_history));
+    app.add_command("AddText"s, std::make_shared<AddTextCmd>(doc, console, cmd_history));
     app.add_command("Paste"s, std::make_shared<PasteCmd>(doc, shared_clipboard, cmd_history));
-    app.add_command("Undo"s, std::make_shared<UndoCmd>(terminal, cmd_history));
+    app.add_command("Undo"s, std::make_shared<UndoCmd>(console, cmd_history));
+    app.add_command("Redo"s, std::make_shared<RedoCmd>(console, cmd_history));
+
+    // one undo step for both edits
+    auto paste_upper = std::make_shared<MacroCmd>(doc, cmd_history);
+    paste_upper->add(std::make_shared<PasteCmd>(doc, shared_clipboard, cmd_history))
+        .add(std::make_shared<ToUpperCmd>(doc, cmd_history));
+    app.add_command("PasteUpper"s, paste_upper);
 
     // TODO - register two commands: CopyCmd & ToLowerCmd
 
+    // Command.Exercise --script <file> - runs the commands from the file and reports their timing;
+    // the rest of a line is the input of its command, e.g. "AddText Hello"
+    if (argc == 3 && std::strcmp(argv[1], "--script") == 0)
+    {
+        std::ifstream script{argv[2]};
+        if (!script)
+        {
+            cerr << "Cannot open script: " << argv[2] << endl;
+            return 1;
+        }
+
+        try
+        {
+            app.print_report(app.run_script(script, console));
+        }
+        catch (const std::invalid_argument& e)
+        {
+            cerr << e.what() << endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
     app.run();
 }
@@ -2,8 +2,15 @@
 #define APPLICATION_HPP
 
 #include <algorithm>
+#include <chrono>
+#include <istream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
+#include "ascii_case.hpp"
 #include "command.hpp"
 #include "console.hpp"
 
@@ -13,6 +20,25 @@ namespace Messages
     constexpr auto msg_prompt = "Enter a command: ";
 };
 
+struct ScriptReport
+{
+    struct CommandTiming
+    {
+        std::string name;
+        size_t executions{};
+        std::chrono::nanoseconds total_time{};
+    };
+
+    std::vector<CommandTiming> commands; // in order of first use in the script
+    size_t executions{};
+    std::chrono::nanoseconds total_time{};
+
+    double commands_per_second() const
+    {
+        return total_time.count() > 0 ? executions / std::chrono::duration<double>(total_time).count() : 0.0;
+    }
+};
+
 class Application
 {
     static const std::string cmd_exit;
@@ -49,6 +75,100 @@ public:
         }
     }
 
+    // Runs a script - a command name per line, optionally followed by its input: the rest of
+    // the line is fed to input before the command runs ("AddText Hello World"), the part that
+    // the command does not read is dropped. Commands that need input must be registered with
+    // input - without an argument on its line a command reads from the console behind it.
+    // Empty lines & lines starting with '#' are skipped, EXIT ends the script. Names are resolved
+    // once, before anything is executed, so a script with an unknown command is rejected as
+    // a whole (std::invalid_argument). Time spent waiting for console input is not counted.
+    ScriptReport run_script(std::istream& script, ScriptConsole& input)
+    {
+        struct Step
+        {
+            size_t command;
+            std::optional<std::string> argument;
+        };
+
+        ScriptReport report;
+        std::vector<Command*> commands; // parallel to report.commands
+        std::unordered_map<std::string, size_t> command_index;
+        std::vector<Step> steps;
+
+        constexpr auto blanks = " \t\r";
+
+        std::string line;
+        for (size_t line_no = 1; std::getline(script, line); ++line_no)
+        {
+            const size_t name_start = line.find_first_not_of(blanks);
+            if (name_start == std::string::npos || line[name_start] == '#')
+                continue;
+
+            const size_t name_end = std::min(line.find_first_of(blanks, name_start), line.size());
+            std::string name = line.substr(name_start, name_end - name_start);
+
+            to_upper(name);
+            if (name == Commands::cmd_exit)
+                break;
+
+            auto cmd = cmds_.find(name);
+            if (cmd == cmds_.end())
+                throw std::invalid_argument("Invalid command in line " + std::to_string(line_no) + ": " + line);
+
+            auto [index, inserted] = command_index.try_emplace(name, commands.size());
+            if (inserted)
+            {
+                commands.push_back(cmd->second.get());
+                report.commands.push_back({name});
+            }
+
+            Step step{index->second, std::nullopt};
+            if (const size_t argument_start = line.find_first_not_of(blanks, name_end); argument_start != std::string::npos)
+                step.argument = line.substr(argument_start, line.find_last_not_of('\r') + 1 - argument_start);
+            steps.push_back(std::move(step));
+        }
+
+        auto step_start = std::chrono::steady_clock::now();
+        for (auto& step : steps)
+        {
+            const auto input_wait = input.input_wait();
+
+            input.clear_input();
+            if (step.argument)
+                input.feed(std::move(*step.argument));
+
+            commands[step.command]->execute();
+
+            const auto step_end = std::chrono::steady_clock::now();
+            const auto step_time = step_end - step_start - (input.input_wait() - input_wait);
+            auto& timing = report.commands[step.command];
+            ++timing.executions;
+            timing.total_time += step_time;
+            report.total_time += step_time;
+            step_start = step_end;
+        }
+
+        input.clear_input();
+        report.executions = steps.size();
+
+        return report;
+    }
+
+    void print_report(const ScriptReport& report)
+    {
+        for (const auto& timing : report.commands)
+        {
+            std::ostringstream line;
+            line << timing.name << ": " << timing.executions << " x, " << timing.total_time.count() / timing.executions << " ns avg";
+            console_.print(line.str());
+        }
+
+        std::ostringstream summary;
+        summary << report.executions << " commands in " << std::chrono::duration<double, std::milli>(report.total_time).count()
+                << " ms (" << static_cast<long long>(report.commands_per_second()) << " commands/s)";
+        console_.print(summary.str());
+    }
+
     void add_command(std::string name, CommandSharedPtr cmd)
     {
         to_upper(name);
@@ -57,7 +177,7 @@ public:
 public:
     void to_upper(std::string& text)
     {
-        std::transform(text.begin(), text.end(), text.begin(), [](auto c) { return std::toupper(c);});
+        AsciiCase::to_upper(text);
     }
 };
 
@@ -0,0 +1,165 @@
+#include "ascii_case.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    constexpr size_t block_size = 64; // bytes per bitmap word
+    constexpr char case_bit = 'a' - 'A';
+
+    bool changes(char c, bool to_upper)
+    {
+        return to_upper ? (c >= 'a' && c <= 'z') : (c >= 'A' && c <= 'Z');
+    }
+
+#if defined(__SSE2__)
+    // letters to convert are mapped to the 26 smallest signed bytes by the bias, so one
+    // signed comparison checks both bounds
+    struct LetterMask
+    {
+        __m128i bias;
+        __m128i limit;
+
+        explicit LetterMask(bool to_upper)
+            : bias{_mm_set1_epi8(static_cast<char>(-128 - (to_upper ? 'a' : 'A')))}
+            , limit{_mm_set1_epi8(static_cast<char>(-128 + 26))}
+        {
+        }
+
+        __m128i operator()(__m128i bytes) const
+        {
+            return _mm_cmplt_epi8(_mm_add_epi8(bytes, bias), limit);
+        }
+    };
+
+    std::uint64_t block_changes(const char* data, const LetterMask& letters)
+    {
+        std::uint64_t bits = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i));
+            bits |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(letters(bytes)))} << (16 * i);
+        }
+        return bits;
+    }
+
+    std::uint64_t convert_block(char* data, const LetterMask& letters)
+    {
+        const __m128i flip = _mm_set1_epi8(case_bit);
+
+        std::uint64_t bits = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            auto* chunk = reinterpret_cast<__m128i*>(data + 16 * i);
+            const __m128i bytes = _mm_loadu_si128(chunk);
+            const __m128i mask = letters(bytes);
+            const auto chunk_bits = static_cast<std::uint16_t>(_mm_movemask_epi8(mask));
+            if (chunk_bits != 0)
+                _mm_storeu_si128(chunk, _mm_xor_si128(bytes, _mm_and_si128(mask, flip)));
+            bits |= std::uint64_t{chunk_bits} << (16 * i);
+        }
+        return bits;
+    }
+#else
+    struct LetterMask
+    {
+        bool to_upper;
+
+        explicit LetterMask(bool to_upper)
+            : to_upper{to_upper}
+        {
+        }
+    };
+
+    std::uint64_t block_changes(const char* data, const LetterMask& letters)
+    {
+        std::uint64_t bits = 0;
+        for (size_t i = 0; i < block_size; ++i)
+            bits |= std::uint64_t{changes(data[i], letters.to_upper)} << i;
+        return bits;
+    }
+
+    std::uint64_t convert_block(char* data, const LetterMask& letters)
+    {
+        const std::uint64_t bits = block_changes(data, letters);
+        for (size_t i = 0; i < block_size; ++i)
+            data[i] ^= ((bits >> i) & 1) ? case_bit : 0;
+        return bits;
+    }
+#endif
+
+    int lowest_bit(std::uint64_t bits)
+    {
+        return __builtin_ctzll(bits);
+    }
+
+    int highest_bit(std::uint64_t bits)
+    {
+        return 63 - __builtin_clzll(bits);
+    }
+} // namespace
+
+AsciiCase::Range AsciiCase::find_changes(const char* data, size_t size, bool to_upper)
+{
+    const LetterMask letters{to_upper};
+
+    Range range{size, size};
+    auto mark = [&](size_t offset, std::uint64_t bits) {
+        if (bits == 0)
+            return;
+        if (range.first == size)
+            range.first = offset + lowest_bit(bits);
+        range.last = offset + highest_bit(bits) + 1;
+    };
+
+    size_t offset = 0;
+    for (; offset + block_size <= size; offset += block_size)
+        mark(offset, block_changes(data + offset, letters));
+
+    std::uint64_t tail_bits = 0;
+    for (size_t i = offset; i < size; ++i)
+        tail_bits |= std::uint64_t{changes(data[i], to_upper)} << (i - offset);
+    mark(offset, tail_bits);
+
+    if (range.first == size)
+        range.last = size;
+
+    return range;
+}
+
+void AsciiCase::convert(char* data, size_t size, bool to_upper, std::uint64_t* changed)
+{
+    const LetterMask letters{to_upper};
+
+    size_t offset = 0;
+    for (; offset + block_size <= size; offset += block_size)
+    {
+        const std::uint64_t bits = convert_block(data + offset, letters);
+        if (changed)
+            changed[offset / block_size] = bits;
+    }
+
+    std::uint64_t tail_bits = 0;
+    for (size_t i = offset; i < size; ++i)
+    {
+        if (changes(data[i], to_upper))
+        {
+            data[i] ^= case_bit;
+            tail_bits |= std::uint64_t{1} << (i - offset);
+        }
+    }
+    if (changed && offset < size)
+        changed[offset / block_size] = tail_bits;
+}
+
+void AsciiCase::revert(char* data, size_t size, const std::uint64_t* changed)
+{
+    const size_t words = (size + block_size - 1) / block_size;
+    for (size_t word = 0; word < words; ++word)
+    {
+        for (std::uint64_t bits = changed[word]; bits != 0; bits &= bits - 1)
+            data[word * block_size + lowest_bit(bits)] ^= case_bit;
+    }
+}
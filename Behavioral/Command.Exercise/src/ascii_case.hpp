@@ -0,0 +1,55 @@
+#ifndef ASCII_CASE_HPP
+#define ASCII_CASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Locale-independent case conversion of ASCII letters - other bytes (including UTF-8
+// sequences) are never changed, like std::toupper/std::tolower in the "C" locale.
+// With SSE2 the kernels process 64 bytes per step - one 64-bit word of a change bitmap.
+namespace AsciiCase
+{
+    inline char to_upper(char c)
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c;
+    }
+
+    inline char to_lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    // [first, last) - the span from the first to the last character changed by a conversion
+    struct Range
+    {
+        size_t first;
+        size_t last;
+
+        bool empty() const
+        {
+            return first == last;
+        }
+    };
+
+    Range find_changes(const char* data, size_t size, bool to_upper);
+
+    // converts in place; when changed is not null it receives (size + 63) / 64 words with
+    // bit i % 64 of word i / 64 set when data[i] was changed
+    void convert(char* data, size_t size, bool to_upper, std::uint64_t* changed = nullptr);
+
+    // switches back the case of the characters marked in the bitmap made by convert
+    void revert(char* data, size_t size, const std::uint64_t* changed);
+
+    inline void to_upper(std::string& text)
+    {
+        convert(text.data(), text.size(), true);
+    }
+
+    inline void to_lower(std::string& text)
+    {
+        convert(text.data(), text.size(), false);
+    }
+} // namespace AsciiCase
+
+#endif // ASCII_CASE_HPP
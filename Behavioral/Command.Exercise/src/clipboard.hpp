@@ -1,7 +1,8 @@
 #ifndef CLIPBOARD_HPP
 #define CLIPBOARD_HPP
 
-#include <mutex>
+#include <atomic>
+#include <memory>
 #include <string>
 
 class Clipboard
@@ -9,13 +10,22 @@ class Clipboard
 public:
     virtual std::string content() const = 0;
     virtual void set_content(const std::string& content) = 0;
+
+    // immutable content - pasting it does not need a copy
+    virtual std::shared_ptr<const std::string> snapshot() const
+    {
+        return std::make_shared<const std::string>(content());
+    }
+
     virtual ~Clipboard() = default;
 };
 
+// The content is an immutable buffer published atomically - readers share it with
+// a reference count instead of copying it under a lock. set_content replaces the buffer;
+// snapshots taken before keep the old one alive.
 class SharedClipboard : public Clipboard
 {
-    std::string content_;
-    mutable std::mutex content_mtx_;
+    std::atomic<std::shared_ptr<const std::string>> content_{std::make_shared<const std::string>()};
 
 public:
     Clipboard& instance()
@@ -27,16 +37,17 @@ public:
 
     std::string content() const override
     {
-        std::lock_guard<std::mutex> lk{content_mtx_};
-
-        return content_;
+        return *snapshot();
     }
 
     void set_content(const std::string& content) override
     {
-        std::lock_guard<std::mutex> lk{content_mtx_};
+        content_.store(std::make_shared<const std::string>(content));
+    }
 
-        content_ = content;
+    std::shared_ptr<const std::string> snapshot() const override
+    {
+        return content_.load();
     }
 };
 
@@ -4,8 +4,15 @@
 #include "clipboard.hpp"
 #include "console.hpp"
 #include "document.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
 #include <memory>
-#include <stack>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace Commands
 {
@@ -27,6 +34,33 @@ class ReversibleCommand : public Command
 public:
     virtual void undo() = 0;
     virtual std::unique_ptr<ReversibleCommand> clone() const = 0; // Prototype Pattern
+
+    // executes the command again after undo - with the input captured by the first execution
+    virtual void redo()
+    {
+        execute();
+    }
+
+    // executes the command as a step of another one - without saving undo state and recording history
+    virtual void apply()
+    {
+        execute();
+    }
+
+    // bytes kept alive by the command while it stays in the history
+    virtual size_t memory_footprint() const
+    {
+        return sizeof(ReversibleCommand);
+    }
+
+    // Moves the command (with its undo state) into storage of the given size - or to the heap
+    // when it does not fit. The returned command is destroyed by the caller: in place or by delete.
+    // The moved-from command must stay executable: its configuration (references, steps of
+    // a macro ...) has to survive the move - only the undo state is moved out.
+    virtual ReversibleCommand* move_into(void* /*storage*/, size_t /*size*/)
+    {
+        return clone().release();
+    }
 };
 
 using ReversibleCommandPtr = std::unique_ptr<ReversibleCommand>;
@@ -40,30 +74,291 @@ public:
     {
         return std::make_unique<Cmd>(static_cast<Cmd const&>(*this));
     }
+
+    ReversibleCommand* move_into(void* storage, size_t size) override
+    {
+        if (storage && sizeof(Cmd) <= size && alignof(Cmd) <= alignof(std::max_align_t))
+            return new (storage) Cmd(std::move(static_cast<Cmd&>(*this)));
+
+        return new Cmd(std::move(static_cast<Cmd&>(*this)));
+    }
+
+    size_t memory_footprint() const override
+    {
+        return sizeof(Cmd);
+    }
 };
 
+// Owner of a recorded command - a command of up to inline_size bytes is kept in the entry
+// itself, a larger one spills to the heap. Moving an entry moves the command between buffers.
+class HistoryEntry
+{
+public:
+    static constexpr size_t inline_size = 96;
+
+    HistoryEntry() = default;
+
+    // takes over the state of cmd
+    explicit HistoryEntry(ReversibleCommand&& cmd)
+    {
+        adopt(cmd.move_into(storage_, inline_size));
+    }
+
+    explicit HistoryEntry(ReversibleCommandPtr cmd)
+        : cmd_{cmd.release()}
+    {
+    }
+
+    HistoryEntry(const HistoryEntry&) = delete;
+    HistoryEntry& operator=(const HistoryEntry&) = delete;
+
+    HistoryEntry(HistoryEntry&& other) noexcept
+    {
+        take(other);
+    }
+
+    HistoryEntry& operator=(HistoryEntry&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~HistoryEntry()
+    {
+        reset();
+    }
+
+    ReversibleCommand* operator->() const
+    {
+        return cmd_;
+    }
+
+    bool is_inline() const
+    {
+        return is_inline_;
+    }
+
+    // the command on the heap
+    ReversibleCommandPtr release()
+    {
+        if (!is_inline_)
+            return ReversibleCommandPtr{std::exchange(cmd_, nullptr)};
+
+        ReversibleCommandPtr cmd{cmd_->move_into(nullptr, 0)};
+        reset();
+        return cmd;
+    }
+
+    void reset()
+    {
+        if (!cmd_)
+            return;
+
+        if (is_inline_)
+            cmd_->~ReversibleCommand();
+        else
+            delete cmd_;
+
+        cmd_ = nullptr;
+        is_inline_ = false;
+    }
+
+private:
+    alignas(std::max_align_t) std::byte storage_[inline_size];
+    ReversibleCommand* cmd_{};
+    bool is_inline_{};
+
+    void adopt(ReversibleCommand* cmd)
+    {
+        const auto* address = reinterpret_cast<const std::byte*>(cmd);
+        cmd_ = cmd;
+        is_inline_ = !std::less<>{}(address, storage_) && std::less<>{}(address, storage_ + inline_size);
+    }
+
+    void take(HistoryEntry& other)
+    {
+        if (other.is_inline_)
+        {
+            adopt(other.cmd_->move_into(storage_, inline_size));
+            other.reset();
+        }
+        else
+        {
+            cmd_ = std::exchange(other.cmd_, nullptr);
+            is_inline_ = false;
+        }
+    }
+};
+
+// Undo & redo stacks limited by a memory budget - when the recorded commands take more than
+// the budget, the oldest ones are dropped (they can no longer be undone). The last recorded
+// command is always kept, even if it alone exceeds the budget.
+// Commands are kept in inline history entries: the undo stack is a ring of entries and the
+// redo stack a vector of them, both growing geometrically, so recording, undoing and redoing
+// a command allocate nothing once the history has reached its working size.
 class CommandHistory
 {
-    std::stack<ReversibleCommandPtr> history_;
+    static constexpr size_t initial_capacity = 16;
+
+    std::vector<HistoryEntry> undo_ring_; // the oldest command at undo_first_
+    size_t undo_first_{};
+    size_t undo_count_{};
+    std::vector<HistoryEntry> redo_stack_;
+    size_t memory_budget_;
+    size_t memory_used_{};
 
 public:
+    static constexpr size_t unlimited = std::numeric_limits<size_t>::max();
+
+    explicit CommandHistory(size_t memory_budget = unlimited)
+        : memory_budget_{memory_budget}
+    {
+    }
+
+    // a new command makes the undone ones impossible to redo
     void record_last_command(ReversibleCommandPtr cmd)
     {
-        history_.push(std::move(cmd));
+        record(HistoryEntry{std::move(cmd)});
     }
 
-    ReversibleCommandPtr pop_last_command()
+    // takes over the state of cmd - stored inline when it fits in a history entry
+    void record_last_command(ReversibleCommand&& cmd)
     {
+        record(HistoryEntry{std::move(cmd)});
+    }
 
-        if (history_.empty())
+    // allocates when the command was stored inline
+    ReversibleCommandPtr pop_last_command()
+    {
+        if (undo_count_ == 0)
             throw std::out_of_range("Command history is empty");
-        auto last_cmd = std::move(history_.top());
-        history_.pop();
 
-        return last_cmd;
+        HistoryEntry last_cmd = pop_undo();
+        memory_used_ -= last_cmd->memory_footprint();
+
+        return last_cmd.release();
+    }
+
+    // returns false when there is nothing to undo - a command whose undo() throws stays in the history
+    bool undo()
+    {
+        if (undo_count_ == 0)
+            return false;
+
+        if (redo_stack_.size() == redo_stack_.capacity())
+            redo_stack_.reserve(std::max(initial_capacity, 2 * redo_stack_.capacity()));
+
+        HistoryEntry& last_cmd = undo_ring_[(undo_first_ + undo_count_ - 1) % undo_ring_.size()];
+        const size_t footprint = last_cmd->memory_footprint();
+
+        last_cmd->undo();
+
+        memory_used_ = memory_used_ - footprint + last_cmd->memory_footprint();
+        redo_stack_.push_back(pop_undo()); // no reallocation - reserved above
+
+        return true;
+    }
+
+    // returns false when there is nothing to redo - a command whose redo() throws stays redoable
+    bool redo()
+    {
+        if (redo_stack_.empty())
+            return false;
+
+        if (undo_count_ == undo_ring_.size())
+            grow_undo_ring();
+
+        HistoryEntry& cmd = redo_stack_.back();
+        const size_t footprint = cmd->memory_footprint();
+
+        cmd->redo();
+
+        memory_used_ = memory_used_ - footprint + cmd->memory_footprint();
+        push_undo(std::move(cmd)); // no reallocation - the ring has grown above
+        redo_stack_.pop_back();
+
+        return true;
+    }
+
+    size_t undo_count() const
+    {
+        return undo_count_;
+    }
+
+    size_t redo_count() const
+    {
+        return redo_stack_.size();
+    }
+
+    size_t memory_used() const
+    {
+        return memory_used_;
+    }
+
+    size_t memory_budget() const
+    {
+        return memory_budget_;
+    }
+
+private:
+    void record(HistoryEntry entry)
+    {
+        clear_redo();
+
+        memory_used_ += entry->memory_footprint();
+        push_undo(std::move(entry));
+
+        while (memory_used_ > memory_budget_ && undo_count_ > 1)
+        {
+            HistoryEntry& oldest = undo_ring_[undo_first_];
+            memory_used_ -= oldest->memory_footprint();
+            oldest.reset();
+            undo_first_ = (undo_first_ + 1) % undo_ring_.size();
+            --undo_count_;
+        }
+    }
+
+    void push_undo(HistoryEntry entry)
+    {
+        if (undo_count_ == undo_ring_.size())
+            grow_undo_ring();
+
+        undo_ring_[(undo_first_ + undo_count_) % undo_ring_.size()] = std::move(entry);
+        ++undo_count_;
+    }
+
+    HistoryEntry pop_undo()
+    {
+        --undo_count_;
+        return std::move(undo_ring_[(undo_first_ + undo_count_) % undo_ring_.size()]);
+    }
+
+    void grow_undo_ring()
+    {
+        std::vector<HistoryEntry> ring(std::max(initial_capacity, 2 * undo_ring_.size()));
+        for (size_t i = 0; i < undo_count_; ++i)
+            ring[i] = std::move(undo_ring_[(undo_first_ + i) % undo_ring_.size()]);
+
+        undo_ring_.swap(ring);
+        undo_first_ = 0;
+    }
+
+    void clear_redo()
+    {
+        for (const auto& cmd : redo_stack_)
+            memory_used_ -= cmd->memory_footprint();
+        redo_stack_.clear();
     }
 };
 
+// execute() moves the command into the history, so the same object - e.g. registered once
+// in Application - is executed many times. A command keeps its configuration in members that
+// survive a move (references) or moves only its undo state in its move constructor;
+// do_save_state and do_execute set the whole undo state again on every execution.
 template <typename CommandType, typename CommandBaseType = ReversibleCommand>
 class ReversibleCommandBase : public CloneableCommand<CommandType, CommandBaseType>
 {
@@ -78,8 +373,8 @@ public:
     void execute() final override // Template Method Pattern
     {
         do_save_state();
-        history_.record_last_command(this->clone());
         do_execute();
+        history_.record_last_command(std::move(*this)); // undo state may be captured by do_execute
     }
 
     void undo() final override // Template Method Pattern
@@ -87,10 +382,27 @@ public:
         do_undo();
     }
 
+    void redo() final override // Template Method Pattern
+    {
+        do_redo();
+    }
+
+    void apply() final override
+    {
+        do_execute();
+    }
+
 protected:
     virtual void do_save_state() = 0;
     virtual void do_execute() = 0;
     virtual void do_undo() = 0;
+
+    // commands that read input in do_execute replay the captured input instead
+    virtual void do_redo()
+    {
+        do_save_state();
+        do_execute();
+    }
 };
 
 //--------------------------------------------------------------------------------
@@ -128,7 +440,7 @@ public:
 protected:
     void do_save_state() override
     {
-        memento_ = doc_.create_memento();
+        snapshot_ = doc_.snapshot(); // O(1) - shares the text, nothing is copied
     }
 
     void do_execute() override
@@ -138,12 +450,19 @@ protected:
 
     void do_undo() override
     {
-        doc_.set_memento(memento_);
+        doc_.restore(snapshot_); // the snapshot is kept for redo
+    }
+
+public:
+    // the cleared text is owned by the snapshot only
+    size_t memory_footprint() const override
+    {
+        return sizeof(ClearCmd) + snapshot_.size();
     }
 
 private:
     Document& doc_;
-    Document::Memento memento_;
+    Rope snapshot_;
 };
 
 //--------------------------------------------------------------------------------
@@ -160,22 +479,28 @@ public:
 protected:
     void do_save_state() override
     {
-        memento_ = doc_.create_memento();
+        // only the positions changed by do_execute are recorded
     }
 
     void do_execute() override
     {
-        doc_.to_upper();
+        case_change_ = doc_.to_upper();
     }
 
     void do_undo() override
     {
-        doc_.set_memento(memento_);
+        doc_.revert(case_change_);
+    }
+
+public:
+    size_t memory_footprint() const override
+    {
+        return sizeof(ToUpperCmd) + case_change_.memory_footprint();
     }
 
 private:
     Document& doc_;
-    Document::Memento memento_;
+    Document::CaseChange case_change_;
 };
 
 //--------------------------------------------------------------------------------
@@ -198,7 +523,8 @@ protected:
 
     void do_execute() override
     {
-        doc_.add_text(clipboard_.content());
+        pasted_text_ = clipboard_.snapshot();
+        doc_.add_text(pasted_text_);
     }
 
     void do_undo() override
@@ -207,11 +533,24 @@ protected:
         doc_.replace(prev_length_, count, "");
     }
 
+    void do_redo() override
+    {
+        do_save_state();
+        doc_.add_text(pasted_text_);
+    }
+
+public:
+    size_t memory_footprint() const override
+    {
+        return sizeof(PasteCmd) + (pasted_text_ ? pasted_text_->size() : 0);
+    }
+
 private:
     Document& doc_;
     Clipboard& clipboard_;
 
     size_t prev_length_{};
+    std::shared_ptr<const std::string> pasted_text_; // shared with the clipboard & the document
 };
 
 //--------------------------------------------------------------------------------
@@ -227,15 +566,30 @@ public:
 
     void execute() override
     {
-        try
-        {
-            auto last_cmd = history_.pop_last_command();
-            last_cmd->undo();
-        }
-        catch (const std::out_of_range&)
-        {
+        if (!history_.undo())
             console_.print("Command history is empty. Nothing to undo.");
-        }
+    }
+
+private:
+    Console& console_;
+    CommandHistory& history_;
+};
+
+//--------------------------------------------------------------------------------
+// Redo command
+class RedoCmd : public Command
+{
+public:
+    RedoCmd(Console& console, CommandHistory& history)
+        : console_{console}
+        , history_(history)
+    {
+    }
+
+    void execute() override
+    {
+        if (!history_.redo())
+            console_.print("Nothing to redo.");
     }
 
 private:
@@ -264,8 +618,8 @@ protected:
     void do_execute() override
     {
         console_.print("Write text: ");
-        auto txt = console_.get_line();
-        doc_.add_text(txt);
+        text_ = console_.get_line();
+        doc_.add_text(text_);
     }
 
     void do_undo() override
@@ -274,10 +628,109 @@ protected:
         doc_.replace(prev_length_, count, "");
     }
 
+    void do_redo() override
+    {
+        do_save_state();
+        doc_.add_text(text_);
+    }
+
+public:
+    size_t memory_footprint() const override
+    {
+        return sizeof(AddTextCmd) + text_.capacity();
+    }
+
 private:
     Document& doc_;
     Console& console_;
     size_t prev_length_{};
+    std::string text_;
+};
+
+//--------------------------------------------------------------------------------
+// Macro command - runs its steps as one transaction (Composite Pattern)
+// Steps are applied without saving their undo state, so the whole sequence is undone
+// by restoring a single snapshot of the document and takes one entry in the history.
+// If a step throws, the document is restored and the macro is not recorded.
+class MacroCmd : public ReversibleCommandBase<MacroCmd>
+{
+public:
+    MacroCmd(Document& doc, CommandHistory& history)
+        : ReversibleCommandBase{history}
+        , doc_{doc}
+    {
+    }
+
+    MacroCmd(const MacroCmd&) = default;
+
+    // the history entry takes only the undo state - the steps stay with the macro,
+    // so it can be executed again
+    MacroCmd(MacroCmd&& other) noexcept
+        : ReversibleCommandBase{std::move(other)}
+        , doc_{other.doc_}
+        , before_{std::move(other.before_)}
+        , after_{std::move(other.after_)}
+        , changed_size_{other.changed_size_}
+    {
+    }
+
+    MacroCmd& add(std::shared_ptr<ReversibleCommand> step)
+    {
+        steps_.push_back(std::move(step));
+        return *this;
+    }
+
+    size_t size() const
+    {
+        return steps_.size();
+    }
+
+    // the snapshots share the unchanged text, so only the text the steps replaced (kept by
+    // before_) and inserted (kept by after_) is counted - the steps are not part of the entry
+    size_t memory_footprint() const override
+    {
+        return sizeof(MacroCmd) + changed_size_;
+    }
+
+protected:
+    void do_save_state() override
+    {
+        before_ = doc_.snapshot();
+    }
+
+    void do_execute() override
+    {
+        try
+        {
+            for (const auto& step : steps_)
+                step->apply();
+        }
+        catch (...)
+        {
+            doc_.restore(before_);
+            throw;
+        }
+
+        after_ = doc_.snapshot();
+        changed_size_ = before_.difference_size(after_); // counted once - the footprint must not change
+    }
+
+    void do_undo() override
+    {
+        doc_.restore(before_);
+    }
+
+    void do_redo() override
+    {
+        doc_.restore(after_);
+    }
+
+private:
+    Document& doc_;
+    std::vector<std::shared_ptr<ReversibleCommand>> steps_;
+    Rope before_;
+    Rope after_;
+    size_t changed_size_ = 0;
 };
 
 //--------------------------------------------------------------------------------
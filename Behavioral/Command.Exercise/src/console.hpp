@@ -1,8 +1,11 @@
 #ifndef CONSOLE_HPP
 #define CONSOLE_HPP
 
+#include <chrono>
+#include <deque>
 #include <iostream>
 #include <string>
+#include <utility>
 
 class Console
 {
@@ -29,4 +32,57 @@ public:
     }
 };
 
+// Decorator - lines fed in advance (e.g. the arguments of script lines) are read before the
+// decorated console is asked, so a command registered once can take its input from a script.
+// Time spent waiting for the decorated console is summed up in input_wait().
+class ScriptConsole : public Console
+{
+    Console& console_;
+    std::deque<std::string> input_;
+    std::chrono::nanoseconds input_wait_{};
+
+public:
+    explicit ScriptConsole(Console& console)
+        : console_{console}
+    {
+    }
+
+    void feed(std::string line)
+    {
+        input_.push_back(std::move(line));
+    }
+
+    // drops the lines that have not been read
+    void clear_input()
+    {
+        input_.clear();
+    }
+
+    std::chrono::nanoseconds input_wait() const
+    {
+        return input_wait_;
+    }
+
+    std::string get_line() override
+    {
+        if (!input_.empty())
+        {
+            std::string line = std::move(input_.front());
+            input_.pop_front();
+            return line;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        std::string line = console_.get_line();
+        input_wait_ += std::chrono::steady_clock::now() - start;
+
+        return line;
+    }
+
+    void print(const std::string& line) override
+    {
+        console_.print(line);
+    }
+};
+
 #endif // CONSOLE_HPP
@@ -1,16 +1,39 @@
 #ifndef DOCUMENT_HPP
 #define DOCUMENT_HPP
 
+#include "ascii_case.hpp"
+#include "rope.hpp"
 #include "serializers.hpp"
 
 #include <algorithm>
-#include <cctype>
-#include <sstream>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+// Text is stored in a persistent rope - edits are O(log n), snapshots O(1)
 class Document
 {
-    std::string text_;
+public:
+    class CaseChange;
+
+    // notified after every change of the text - e.g. by a journal
+    class Observer
+    {
+    public:
+        virtual void text_added(std::string_view text) = 0;
+        virtual void text_replaced(size_t pos, size_t count, std::string_view text) = 0;
+        virtual void text_cleared() = 0;
+        virtual void case_converted(bool to_upper) = 0;
+        virtual void case_reverted(const CaseChange& change) = 0;
+        virtual void text_restored(const Rope& text) = 0;
+        virtual ~Observer() = default;
+    };
+
+private:
+    Rope text_;
+    Observer* observer_{};
 
 public:
     class Memento
@@ -21,6 +44,27 @@ public:
         friend class Document;
     };
 
+    // Undo record of a case conversion - one bit per position between the first and the last
+    // character that was changed, so its size depends on the edit, not on the document
+    class CaseChange
+    {
+    private:
+        size_t first_{};
+        size_t length_{};
+        std::vector<std::uint64_t> changed_;
+        bool to_upper_{};
+
+    public:
+        size_t memory_footprint() const
+        {
+            return changed_.capacity() * sizeof(std::uint64_t);
+        }
+
+    private:
+        friend class Document;
+        friend class DocumentJournal;
+    };
+
     Document()
         : text_{}
     {
@@ -31,9 +75,41 @@ public:
     {
     }
 
+    // the observer belongs to the document object - a copy starts without one
+    Document(const Document& other)
+        : text_{other.text_}
+    {
+    }
+
+    Document(Document&& other) noexcept
+        : text_{std::move(other.text_)}
+    {
+    }
+
+    // assignment restores the text - the observer is kept and notified
+    Document& operator=(const Document& other)
+    {
+        restore(other.text_);
+        return *this;
+    }
+
+    Document& operator=(Document&& other)
+    {
+        restore(std::move(other.text_));
+        return *this;
+    }
+
+    // copy of the whole text - for_each_chunk and snapshot avoid it
     std::string text() const
     {
-        return text_;
+        return text_.str();
+    }
+
+    // calls f(std::string_view) for consecutive parts of the text
+    template <typename F>
+    void for_each_chunk(F&& f) const
+    {
+        text_.for_each_chunk(std::forward<F>(f));
     }
 
     size_t length() const
@@ -41,52 +117,140 @@ public:
         return text_.size();
     }
 
+    // nullptr detaches the observer
+    void set_observer(Observer* observer)
+    {
+        observer_ = observer;
+    }
+
     void add_text(const std::string& txt)
     {
-        text_ += txt;
+        text_.append(txt);
+
+        if (observer_)
+            observer_->text_added(txt);
     }
 
-    void to_upper()
+    // the document shares the buffer instead of copying it
+    void add_text(std::shared_ptr<const std::string> txt)
     {
-        std::transform(text_.begin(), text_.end(), text_.begin(), [](auto c) { return std::toupper(c); });
+        text_.append(txt);
+
+        if (observer_)
+            observer_->text_added(*txt);
     }
 
-    void to_lower()
+    CaseChange to_upper()
     {
-        std::transform(text_.begin(), text_.end(), text_.begin(), [](auto c) { return std::tolower(c); });
+        return convert_case(true);
+    }
+
+    CaseChange to_lower()
+    {
+        return convert_case(false);
+    }
+
+    void revert(const CaseChange& change)
+    {
+        if (change.length_ == 0)
+            return;
+
+        std::string span = text_.substr(change.first_, change.length_);
+        AsciiCase::revert(span.data(), span.size(), change.changed_.data());
+
+        text_.replace(change.first_, change.length_, std::move(span));
+
+        if (observer_)
+            observer_->case_reverted(change);
     }
 
     void clear()
     {
         text_.clear();
+
+        if (observer_)
+            observer_->text_cleared();
     }
 
-    template <template <typename> class Serializer = StreamOutputSerializer>
-    Memento create_memento() const
+    // O(1) - shares the text with the document
+    Rope snapshot() const
     {
-        std::stringstream stream;
-        {
-            Serializer archive(stream);
-            archive(text_);
-        }
+        return text_;
+    }
+
+    void restore(Rope snapshot)
+    {
+        text_ = std::move(snapshot);
+
+        if (observer_)
+            observer_->text_restored(text_);
+    }
 
+    // the text is written into the memento straight from the rope
+    template <template <typename> class Serializer = BinaryOutputSerializer>
+    Memento create_memento() const
+    {
         Memento memento;
-        memento.snapshot_ = stream.str();
+        memento.snapshot_ = SerializerTraits<Serializer>::save([this](auto& archive) { archive(text_); });
 
         return memento;
     }
 
-    template <template <typename> class Serializer = StreamInputSerializer>
+    template <template <typename> class Serializer = BinaryInputSerializer>
     void set_memento(Memento& memento)
     {
-        std::stringstream stream{memento.snapshot_};
-        Serializer archive(stream);
-        archive(text_);
+        std::string text;
+        SerializerTraits<Serializer>::load(memento.snapshot_, [&text](auto& archive) { archive(text); });
+        text_ = Rope{std::move(text)};
+
+        if (observer_)
+            observer_->text_restored(text_);
     }
 
     void replace(size_t start_pos, size_t count, const std::string& text)
     {
         text_.replace(start_pos, count, text);
+
+        if (observer_)
+            observer_->text_replaced(start_pos, count, text);
+    }
+
+private:
+    CaseChange convert_case(bool to_upper)
+    {
+        CaseChange change;
+        change.to_upper_ = to_upper;
+
+        // only the span from the first to the last changed character is rewritten
+        size_t first = std::string::npos;
+        size_t last = 0;
+        size_t pos = 0;
+        text_.for_each_chunk([&](std::string_view chunk) {
+            const auto changes = AsciiCase::find_changes(chunk.data(), chunk.size(), to_upper);
+            if (!changes.empty())
+            {
+                first = std::min(first, pos + changes.first);
+                last = pos + changes.last;
+            }
+            pos += chunk.size();
+        });
+
+        if (first == std::string::npos)
+            return change;
+
+        change.first_ = first;
+        change.length_ = last - first;
+        change.changed_.resize((change.length_ + 63) / 64);
+
+        std::string span = text_.substr(first, change.length_);
+        AsciiCase::convert(span.data(), span.size(), to_upper, change.changed_.data());
+
+        text_.replace(first, change.length_, std::move(span));
+
+        if (observer_)
+            observer_->case_converted(to_upper);
+
+        return change;
     }
 };
 
@@ -0,0 +1,194 @@
+#ifndef DOCUMENT_SERVICE_HPP
+#define DOCUMENT_SERVICE_HPP
+
+#include "command.hpp"
+#include "document.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+
+// Serial executor on a shared pool - tasks run one at a time, in order of posting, on any
+// thread of the pool. A strand occupies a pool thread only while it has tasks, and gives
+// the thread back after a batch, so a busy strand does not starve the others.
+class Strand
+{
+    static constexpr size_t batch_size = 16;
+
+    ThreadPool& pool_;
+    std::mutex tasks_mtx_;
+    std::queue<std::function<void()>> tasks_;
+    bool scheduled_{};
+
+public:
+    explicit Strand(ThreadPool& pool)
+        : pool_{pool}
+    {
+    }
+
+    Strand(const Strand&) = delete;
+    Strand& operator=(const Strand&) = delete;
+
+    // the task must not throw
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard lk{tasks_mtx_};
+            tasks_.push(std::move(task));
+            if (std::exchange(scheduled_, true))
+                return;
+        }
+        pool_.post([this] { run_batch(); });
+    }
+
+private:
+    void run_batch()
+    {
+        for (size_t i = 0; i < batch_size; ++i)
+        {
+            std::function<void()> task;
+            {
+                std::lock_guard lk{tasks_mtx_};
+                if (tasks_.empty())
+                {
+                    scheduled_ = false;
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+
+        pool_.post([this] { run_batch(); });
+    }
+};
+
+struct DocumentSession
+{
+    Document document;
+    CommandHistory history;
+
+    DocumentSession(std::string text, size_t history_budget)
+        : document{std::move(text)}
+        , history{history_budget}
+    {
+    }
+};
+
+// Hosts many documents, each with its own command history. Commands for one document run
+// in order of submission on its strand; commands for different documents run in parallel
+// on a shared thread pool.
+class DocumentService
+{
+public:
+    using DocumentId = size_t;
+
+    explicit DocumentService(size_t threads = std::max(1u, std::thread::hardware_concurrency()),
+        size_t history_budget = CommandHistory::unlimited)
+        : history_budget_{history_budget}
+        , pool_{threads}
+    {
+    }
+
+    DocumentService(const DocumentService&) = delete;
+    DocumentService& operator=(const DocumentService&) = delete;
+
+    // waits for the submitted commands
+    ~DocumentService()
+    {
+        wait();
+    }
+
+    DocumentId open(std::string text = {})
+    {
+        std::unique_lock lk{sessions_mtx_};
+        sessions_.push_back(std::make_unique<Entry>(std::move(text), history_budget_, pool_));
+        return sessions_.size() - 1;
+    }
+
+    size_t size() const
+    {
+        std::shared_lock lk{sessions_mtx_};
+        return sessions_.size();
+    }
+
+    // runs work(DocumentSession&) on the strand of the document; the future gets its result or exception
+    template <typename Work>
+    auto submit(DocumentId id, Work work) -> std::future<decltype(work(std::declval<DocumentSession&>()))>
+    {
+        using Result = decltype(work(std::declval<DocumentSession&>()));
+
+        Entry& entry = find(id);
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            [&session = entry.session, work = std::move(work)]() mutable { return work(session); });
+        auto result = task->get_future();
+
+        ++pending_;
+        entry.strand.post([this, task] {
+            (*task)();
+            finished();
+        });
+
+        return result;
+    }
+
+    // blocks until all submitted commands have finished
+    void wait()
+    {
+        std::unique_lock lk{pending_mtx_};
+        pending_cv_.wait(lk, [this] { return pending_ == 0; });
+    }
+
+private:
+    struct Entry
+    {
+        DocumentSession session;
+        Strand strand;
+
+        Entry(std::string text, size_t history_budget, ThreadPool& pool)
+            : session{std::move(text), history_budget}
+            , strand{pool}
+        {
+        }
+    };
+
+    size_t history_budget_;
+
+    mutable std::shared_mutex sessions_mtx_;
+    std::deque<std::unique_ptr<Entry>> sessions_;
+
+    std::atomic<size_t> pending_{}; // submitted, not finished commands
+    std::mutex pending_mtx_;        // only for waiting on pending_cv_
+    std::condition_variable pending_cv_;
+
+    ThreadPool pool_; // destroyed first - its threads finish the queued strand batches
+
+    Entry& find(DocumentId id)
+    {
+        std::shared_lock lk{sessions_mtx_};
+        if (id >= sessions_.size())
+            throw std::out_of_range("Unknown document");
+        return *sessions_[id];
+    }
+
+    void finished()
+    {
+        if (--pending_ == 0)
+        {
+            std::lock_guard lk{pending_mtx_}; // a waiter checking pending_ cannot miss the notification
+            pending_cv_.notify_all();
+        }
+    }
+};
+
+#endif // DOCUMENT_SERVICE_HPP
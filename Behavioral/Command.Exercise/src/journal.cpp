@@ -0,0 +1,681 @@
+#include "journal.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define JOURNAL_POSIX_IO
+#endif
+
+namespace
+{
+    constexpr char journal_magic[8] = {'C', 'M', 'D', 'J', 'R', 'N', 'L', '1'};
+    constexpr char snapshot_magic[8] = {'C', 'M', 'D', 'S', 'N', 'A', 'P', '1'};
+
+    // record: u32 payload size, u32 CRC32 of the payload, payload: u64 sequence, u8 kind, arguments
+    constexpr size_t record_header_size = 8;
+    constexpr size_t payload_header_size = 9;
+
+    enum RecordKind : std::uint8_t
+    {
+        text_added = 1,     // text
+        text_replaced = 2,  // u64 pos, u64 count, text
+        text_cleared = 3,   //
+        case_converted = 4, // u8 to_upper
+        case_reverted = 5,  // u64 first, u64 length, u8 to_upper, u64 words of the change bitmap
+        text_restored = 6   // text - only read; a restore is journaled as a snapshot
+    };
+
+    // larger records - e.g. a huge pasted text - are journaled as a snapshot
+    constexpr size_t max_payload_size = std::numeric_limits<std::uint32_t>::max();
+
+    constexpr size_t snapshot_buffer_size = 1 << 20;
+
+    std::array<std::uint32_t, 256> make_crc_table()
+    {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320u : 0u);
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    std::uint32_t crc32(std::string_view data, std::uint32_t crc = 0)
+    {
+        static const auto table = make_crc_table();
+
+        crc = ~crc;
+        for (unsigned char c : data)
+            crc = table[(crc ^ c) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    // all numbers are stored little-endian
+    void put_u64(std::string& out, std::uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+            out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+
+    void store_u32(char* out, std::uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            out[i] = static_cast<char>(value >> (8 * i));
+    }
+
+    std::uint64_t load_le(const char* in, int size)
+    {
+        std::uint64_t value = 0;
+        for (int i = 0; i < size; ++i)
+            value |= std::uint64_t{static_cast<unsigned char>(in[i])} << (8 * i);
+        return value;
+    }
+
+    class Reader
+    {
+        std::string_view data_;
+
+    public:
+        explicit Reader(std::string_view data)
+            : data_{data}
+        {
+        }
+
+        size_t remaining() const
+        {
+            return data_.size();
+        }
+
+        bool read_u64(std::uint64_t& value)
+        {
+            if (data_.size() < 8)
+                return false;
+            value = load_le(data_.data(), 8);
+            data_.remove_prefix(8);
+            return true;
+        }
+
+        bool read_u8(std::uint8_t& value)
+        {
+            if (data_.empty())
+                return false;
+            value = static_cast<std::uint8_t>(data_[0]);
+            data_.remove_prefix(1);
+            return true;
+        }
+
+        std::string_view rest()
+        {
+            return std::exchange(data_, {});
+        }
+    };
+
+    [[noreturn]] void throw_io_error(const std::string& what, const std::string& path)
+    {
+        throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+    }
+
+    [[noreturn]] void invalid_journal(const std::string& path)
+    {
+        throw std::runtime_error("Invalid journal file " + path);
+    }
+
+    std::string snapshot_path(const std::string& path)
+    {
+        return path + ".snapshot";
+    }
+
+    // empty when the file does not exist
+    std::string read_file(const std::string& path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        if (!file)
+            return {};
+
+        return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    void sync_directory(const std::string& path)
+    {
+#ifdef JOURNAL_POSIX_IO
+        auto directory = std::filesystem::path{path}.parent_path();
+        if (directory.empty())
+            directory = ".";
+
+        const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0)
+            throw_io_error("Cannot open", directory.string());
+        ::fsync(fd);
+        ::close(fd);
+#else
+        (void)path; // the standard library cannot make a rename durable
+#endif
+    }
+} // namespace
+
+// File written at its end - a POSIX descriptor synced with fdatasync where available,
+// otherwise a std::ofstream that is only flushed (no durability across a system crash)
+class DocumentJournal::File
+{
+public:
+    File(std::string path, bool truncate)
+        : path_{std::move(path)}
+    {
+#ifdef JOURNAL_POSIX_IO
+        fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+        if (fd_ < 0)
+            throw_io_error("Cannot open", path_);
+#else
+        open(truncate);
+#endif
+    }
+
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    ~File()
+    {
+#ifdef JOURNAL_POSIX_IO
+        ::close(fd_);
+#endif
+    }
+
+    void append(const char* data, size_t size)
+    {
+#ifdef JOURNAL_POSIX_IO
+        while (size > 0)
+        {
+            const ssize_t written = ::write(fd_, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw_io_error("Cannot write", path_);
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+#else
+        if (!stream_.write(data, static_cast<std::streamsize>(size)))
+            throw_io_error("Cannot write", path_);
+#endif
+    }
+
+    void resize(size_t size)
+    {
+#ifdef JOURNAL_POSIX_IO
+        if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+            throw_io_error("Cannot truncate", path_);
+#else
+        stream_.close();
+        std::error_code error;
+        std::filesystem::resize_file(path_, size, error);
+        open(false);
+        if (error)
+            throw std::runtime_error("Cannot truncate " + path_ + ": " + error.message());
+#endif
+    }
+
+    // makes the data written so far durable
+    void sync()
+    {
+#if defined(JOURNAL_POSIX_IO) && defined(__APPLE__)
+        if (::fsync(fd_) != 0)
+            throw_io_error("Cannot sync", path_);
+#elif defined(JOURNAL_POSIX_IO)
+        if (::fdatasync(fd_) != 0)
+            throw_io_error("Cannot sync", path_);
+#else
+        if (!stream_.flush())
+            throw_io_error("Cannot sync", path_);
+#endif
+    }
+
+private:
+    std::string path_;
+#ifdef JOURNAL_POSIX_IO
+    int fd_{-1};
+#else
+    std::ofstream stream_;
+
+    void open(bool truncate)
+    {
+        stream_.open(path_, std::ios::binary | (truncate ? std::ios::trunc : std::ios::app));
+        if (!stream_)
+            throw_io_error("Cannot open", path_);
+    }
+#endif
+};
+
+DocumentJournal::ReplayState DocumentJournal::replay(const std::string& path, Document& doc)
+{
+    ReplayState state;
+
+    doc.set_observer(nullptr);
+    doc.restore(Rope{});
+
+    // snapshot: magic, u64 sequence, u64 text size, text, u32 CRC32 of the text
+    const std::string snapshot = read_file(snapshot_path(path));
+    if (!snapshot.empty())
+    {
+        constexpr size_t header_size = sizeof(snapshot_magic) + 16;
+        if (snapshot.size() < header_size + 4 || std::memcmp(snapshot.data(), snapshot_magic, sizeof(snapshot_magic)) != 0)
+            invalid_journal(snapshot_path(path));
+
+        const std::uint64_t sequence = load_le(snapshot.data() + 8, 8);
+        const std::uint64_t text_size = load_le(snapshot.data() + 16, 8);
+        if (text_size != snapshot.size() - header_size - 4)
+            invalid_journal(snapshot_path(path));
+
+        std::string_view text{snapshot.data() + header_size, text_size};
+        if (crc32(text) != load_le(snapshot.data() + header_size + text_size, 4))
+            invalid_journal(snapshot_path(path));
+
+        doc.restore(Rope{std::string{text}});
+        state.info.snapshot_loaded = true;
+        state.last_sequence = sequence;
+    }
+
+    const std::uint64_t snapshot_sequence = state.last_sequence;
+
+    const std::string journal = read_file(path);
+    if (journal.size() < sizeof(journal_magic))
+        return state; // missing or torn while being created
+
+    if (std::memcmp(journal.data(), journal_magic, sizeof(journal_magic)) != 0)
+        invalid_journal(path);
+
+    size_t offset = sizeof(journal_magic);
+    while (offset < journal.size())
+    {
+        // a record that is incomplete or fails its checksum is the torn tail of a crashed write
+        if (journal.size() - offset < record_header_size)
+            break;
+
+        const std::uint64_t payload_size = load_le(journal.data() + offset, 4);
+        const std::uint32_t crc = static_cast<std::uint32_t>(load_le(journal.data() + offset + 4, 4));
+        if (payload_size < payload_header_size || payload_size > journal.size() - offset - record_header_size)
+            break;
+
+        const std::string_view payload{journal.data() + offset + record_header_size, payload_size};
+        if (crc32(payload) != crc)
+            break;
+
+        Reader reader{payload};
+        std::uint64_t sequence{};
+        std::uint8_t kind{};
+        reader.read_u64(sequence);
+        reader.read_u8(kind);
+
+        offset += record_header_size + payload_size;
+
+        // records written before the snapshot (its journal was not truncated yet)
+        if (sequence <= snapshot_sequence)
+            continue;
+
+        switch (kind)
+        {
+        case RecordKind::text_added:
+            doc.add_text(std::string{reader.rest()});
+            break;
+        case RecordKind::text_replaced:
+        {
+            std::uint64_t pos{}, count{};
+            if (!reader.read_u64(pos) || !reader.read_u64(count) || pos > doc.length())
+                invalid_journal(path);
+            doc.replace(pos, count, std::string{reader.rest()});
+            break;
+        }
+        case RecordKind::text_cleared:
+            doc.clear();
+            break;
+        case RecordKind::case_converted:
+        {
+            std::uint8_t to_upper{};
+            if (!reader.read_u8(to_upper))
+                invalid_journal(path);
+            to_upper ? doc.to_upper() : doc.to_lower();
+            break;
+        }
+        case RecordKind::case_reverted:
+        {
+            Document::CaseChange change;
+            std::uint64_t first{}, length{};
+            std::uint8_t to_upper{};
+            if (!reader.read_u64(first) || !reader.read_u64(length) || !reader.read_u8(to_upper)
+                || first > doc.length() || length > doc.length() - first || reader.remaining() != (length + 63) / 64 * 8)
+                invalid_journal(path);
+
+            change.first_ = first;
+            change.length_ = length;
+            change.to_upper_ = to_upper != 0;
+            change.changed_.resize((length + 63) / 64);
+            for (auto& word : change.changed_)
+                reader.read_u64(word);
+
+            doc.revert(change);
+            break;
+        }
+        case RecordKind::text_restored:
+            doc.restore(Rope{std::string{reader.rest()}});
+            break;
+        default:
+            invalid_journal(path);
+        }
+
+        state.last_sequence = sequence;
+        ++state.info.replayed_records;
+    }
+
+    state.valid_journal_size = offset;
+    state.info.torn_tail = offset < journal.size();
+
+    return state;
+}
+
+RecoveryInfo DocumentJournal::recover(const std::string& path, Document& doc)
+{
+    return replay(path, doc).info;
+}
+
+DocumentJournal::DocumentJournal(std::string path, Document& doc, JournalOptions options)
+    : path_{std::move(path)}
+    , doc_{doc}
+    , options_{options}
+{
+    const ReplayState state = replay(path_, doc_);
+    recovery_info_ = state.info;
+    sequence_ = state.last_sequence;
+    records_since_snapshot_ = state.info.replayed_records;
+
+    file_ = std::make_unique<File>(path_, false);
+
+    // the torn tail is cut off, so new records follow the last valid one
+    if (state.valid_journal_size < sizeof(journal_magic))
+    {
+        file_->resize(0);
+        file_->append(journal_magic, sizeof(journal_magic));
+    }
+    else
+    {
+        file_->resize(state.valid_journal_size);
+    }
+
+    file_->sync();
+    sync_directory(path_);
+
+    doc_.set_observer(this);
+    committer_ = std::thread{[this] { run_committer(); }};
+}
+
+DocumentJournal::~DocumentJournal()
+{
+    doc_.set_observer(nullptr);
+
+    {
+        std::lock_guard lk{pending_mtx_};
+        stopping_ = true;
+    }
+    pending_cv_.notify_one();
+    committer_.join();
+
+    write_pending(); // an error can no longer be reported
+}
+
+void DocumentJournal::commit()
+{
+    write_pending();
+
+    std::lock_guard lk{pending_mtx_};
+    if (commit_error_)
+        std::rethrow_exception(commit_error_);
+}
+
+void DocumentJournal::snapshot()
+{
+    {
+        std::lock_guard lk{pending_mtx_};
+        request_snapshot();
+    }
+
+    commit();
+}
+
+std::exception_ptr DocumentJournal::error() const
+{
+    std::lock_guard lk{pending_mtx_};
+    return commit_error_;
+}
+
+void DocumentJournal::request_snapshot()
+{
+    // every pending record is older than the snapshot
+    pending_.clear();
+    pending_count_ = 0;
+
+    snapshot_text_ = doc_.snapshot(); // O(1) - the rope shares the text with the document
+    snapshot_sequence_ = sequence_;
+    records_since_snapshot_ = 0;
+}
+
+void DocumentJournal::write_snapshot(const Rope& text, std::uint64_t sequence)
+{
+    const std::string tmp_path = snapshot_path(path_) + ".tmp";
+    {
+        File file{tmp_path, true};
+
+        std::string buffer{snapshot_magic, sizeof(snapshot_magic)};
+        put_u64(buffer, sequence);
+        put_u64(buffer, text.size());
+
+        std::uint32_t crc = 0;
+        text.for_each_chunk([&](std::string_view chunk) {
+            crc = crc32(chunk, crc);
+            buffer.append(chunk);
+            if (buffer.size() >= snapshot_buffer_size)
+            {
+                file.append(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        });
+
+        char crc_bytes[4];
+        store_u32(crc_bytes, crc);
+        buffer.append(crc_bytes, sizeof(crc_bytes));
+        file.append(buffer.data(), buffer.size());
+        file.sync();
+    }
+
+    if (std::rename(tmp_path.c_str(), snapshot_path(path_).c_str()) != 0)
+        throw_io_error("Cannot rename", tmp_path);
+    sync_directory(path_);
+
+    // a crash before the truncation is harmless - recovery skips records older than the snapshot
+    file_->resize(sizeof(journal_magic));
+}
+
+void DocumentJournal::text_added(std::string_view text)
+{
+    begin_record(RecordKind::text_added);
+    record_.append(text);
+    end_record();
+}
+
+void DocumentJournal::text_replaced(size_t pos, size_t count, std::string_view text)
+{
+    begin_record(RecordKind::text_replaced);
+    put_u64(record_, pos);
+    put_u64(record_, count);
+    record_.append(text);
+    end_record();
+}
+
+void DocumentJournal::text_cleared()
+{
+    begin_record(RecordKind::text_cleared);
+    end_record();
+}
+
+void DocumentJournal::case_converted(bool to_upper)
+{
+    begin_record(RecordKind::case_converted);
+    record_.push_back(static_cast<char>(to_upper));
+    end_record();
+}
+
+void DocumentJournal::case_reverted(const Document::CaseChange& change)
+{
+    begin_record(RecordKind::case_reverted);
+    put_u64(record_, change.first_);
+    put_u64(record_, change.length_);
+    record_.push_back(static_cast<char>(change.to_upper_));
+    for (std::uint64_t word : change.changed_)
+        put_u64(record_, word);
+    end_record();
+}
+
+// The whole text changes - undo of ClearCmd or MacroCmd, assignment of a document. The snapshot
+// shares the rope with the document, so the editing thread copies nothing, and the journal is
+// truncated instead of growing by the size of the text. Restores in quick succession end up in
+// one snapshot file.
+void DocumentJournal::text_restored(const Rope&)
+{
+    ++sequence_;
+
+    {
+        std::lock_guard lk{pending_mtx_};
+        if (commit_error_)
+            return;
+
+        request_snapshot();
+    }
+    pending_cv_.notify_one();
+}
+
+void DocumentJournal::begin_record(std::uint8_t kind)
+{
+    record_.assign(record_header_size, '\0');
+    put_u64(record_, ++sequence_);
+    record_.push_back(static_cast<char>(kind));
+}
+
+void DocumentJournal::end_record()
+{
+    const std::string_view payload = std::string_view{record_}.substr(record_header_size);
+    const bool oversized = payload.size() > max_payload_size;
+    if (!oversized)
+    {
+        store_u32(record_.data(), static_cast<std::uint32_t>(payload.size()));
+        store_u32(record_.data() + 4, crc32(payload));
+    }
+    else
+        std::string{}.swap(record_); // the buffer is reused - not kept at that size
+
+    bool notify = false;
+    {
+        std::lock_guard lk{pending_mtx_};
+
+        // the edit is already applied to the document - an I/O error must not fail it
+        if (commit_error_)
+            return;
+
+        if (oversized || ++records_since_snapshot_ >= options_.snapshot_interval)
+        {
+            request_snapshot(); // covers this record too
+            notify = true;
+        }
+        else
+        {
+            if (pending_count_ == 0)
+                pending_since_ = std::chrono::steady_clock::now();
+            pending_.append(record_);
+            ++pending_count_;
+
+            // the committer waits for the first record of a group and for a full group
+            notify = pending_count_ == 1 || pending_count_ == options_.group_commit_size;
+        }
+    }
+    if (notify)
+        pending_cv_.notify_one();
+}
+
+void DocumentJournal::write_pending()
+{
+    std::lock_guard io_lk{io_mtx_};
+
+    std::optional<Rope> snapshot_text;
+    std::uint64_t snapshot_sequence{};
+    {
+        std::lock_guard lk{pending_mtx_};
+        if (commit_error_)
+            return;
+
+        writing_.swap(pending_);
+        pending_count_ = 0;
+        snapshot_text.swap(snapshot_text_);
+        snapshot_sequence = snapshot_sequence_;
+    }
+
+    try
+    {
+        // records pending now are newer than the snapshot - they follow the truncation
+        if (snapshot_text)
+            write_snapshot(*snapshot_text, snapshot_sequence);
+
+        if (!writing_.empty())
+        {
+            file_->append(writing_.data(), writing_.size());
+            file_->sync();
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard lk{pending_mtx_};
+        commit_error_ = std::current_exception();
+        pending_.clear();
+        pending_count_ = 0;
+    }
+
+    writing_.clear();
+}
+
+void DocumentJournal::run_committer()
+{
+    std::unique_lock lk{pending_mtx_};
+
+    while (true)
+    {
+        pending_cv_.wait(lk, [this] { return stopping_ || pending_count_ > 0 || snapshot_text_; });
+        if (stopping_)
+            return;
+
+        // a group is committed when it is full or its first record waited long enough,
+        // a snapshot right away
+        pending_cv_.wait_until(lk, pending_since_ + options_.group_commit_delay, [this] {
+            return stopping_ || snapshot_text_ || pending_count_ == 0 || pending_count_ >= options_.group_commit_size;
+        });
+        if (stopping_)
+            return;
+
+        lk.unlock();
+        write_pending();
+        lk.lock();
+
+        if (commit_error_)
+            return;
+    }
+}
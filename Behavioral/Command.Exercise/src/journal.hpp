@@ -0,0 +1,129 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include "document.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct JournalOptions
+{
+    size_t group_commit_size = 64;                        // records written with a single write & fdatasync
+    std::chrono::milliseconds group_commit_delay{5};      // the longest time a record waits for its group
+    size_t snapshot_interval = 100'000;                   // records between snapshots of the document
+};
+
+struct RecoveryInfo
+{
+    bool snapshot_loaded{};
+    size_t replayed_records{};
+    bool torn_tail{}; // an incomplete or corrupted last record was ignored
+};
+
+// Write-ahead journal of document edits. Every change of the document - an executed, undone
+// or redone command - becomes one compact binary record (sequence number, kind, arguments,
+// CRC32) appended to the journal file. Records are committed in groups: a background thread
+// writes a group with one write() and makes it durable with one fdatasync(), so an edit never
+// waits for the disk. Every snapshot_interval records the whole text is written to
+// <path>.snapshot (atomically - temporary file & rename) and the journal is truncated,
+// which bounds the number of records replayed by recovery. Snapshots are written by the
+// committer thread too, from an O(1) copy of the rope. A restore of the whole text (undo of
+// ClearCmd or MacroCmd, assignment of a document) and a record too large for its u32 size
+// request a snapshot instead of a record, so the journal never holds a copy of the text. An I/O error is kept and reported
+// by commit() - it never fails the edit that is being journaled. Without POSIX the files are
+// written with std::ofstream and only flushed - they survive a crash of the process,
+// not of the system.
+//
+// On a crash the edits of the last group (at most group_commit_delay old) may be lost.
+class DocumentJournal : public Document::Observer
+{
+public:
+    // recovers doc from the snapshot & journal at path (both may be missing) and journals its further edits;
+    // throws std::runtime_error when the files cannot be read or written
+    DocumentJournal(std::string path, Document& doc, JournalOptions options = {});
+    DocumentJournal(const DocumentJournal&) = delete;
+    DocumentJournal& operator=(const DocumentJournal&) = delete;
+    ~DocumentJournal(); // commits pending records
+
+    // state of the document as stored at path
+    static RecoveryInfo recover(const std::string& path, Document& doc);
+
+    const RecoveryInfo& recovery_info() const
+    {
+        return recovery_info_;
+    }
+
+    // makes all journaled edits durable; throws the first I/O error of the journal
+    void commit();
+
+    // writes a snapshot of the document & truncates the journal; throws as commit()
+    void snapshot();
+
+    // the first I/O error, nullptr while the journal works - edits made after it are applied
+    // to the document but not journaled
+    std::exception_ptr error() const;
+
+    std::uint64_t last_sequence() const
+    {
+        return sequence_;
+    }
+
+    void text_added(std::string_view text) override;
+    void text_replaced(size_t pos, size_t count, std::string_view text) override;
+    void text_cleared() override;
+    void case_converted(bool to_upper) override;
+    void case_reverted(const Document::CaseChange& change) override;
+    void text_restored(const Rope& text) override;
+
+private:
+    std::string path_;
+    Document& doc_;
+    JournalOptions options_;
+    RecoveryInfo recovery_info_;
+
+    class File;
+    std::unique_ptr<File> file_;
+
+    std::uint64_t sequence_{};            // of the last record
+    size_t records_since_snapshot_{};
+    std::string record_;                  // reused for encoding
+
+    std::mutex io_mtx_;                   // file writes - taken before pending_mtx_
+    mutable std::mutex pending_mtx_;
+    std::condition_variable pending_cv_;
+    std::string pending_;                 // encoded records waiting for commit
+    size_t pending_count_{};
+    std::chrono::steady_clock::time_point pending_since_;
+    std::string writing_;                 // the group being written
+    std::optional<Rope> snapshot_text_;   // requested snapshot - written before the pending records
+    std::uint64_t snapshot_sequence_{};
+    bool stopping_{};
+    std::exception_ptr commit_error_;     // the first I/O error - journaling stops, commit() throws it
+    std::thread committer_;
+
+    struct ReplayState
+    {
+        RecoveryInfo info;
+        std::uint64_t last_sequence{};
+        size_t valid_journal_size{}; // without the torn tail
+    };
+
+    static ReplayState replay(const std::string& path, Document& doc);
+
+    void begin_record(std::uint8_t kind);
+    void end_record(); // never throws - the document has already changed
+    void request_snapshot();
+    void write_snapshot(const Rope& text, std::uint64_t sequence);
+    void write_pending();
+    void run_committer();
+};
+
+#endif // JOURNAL_HPP
@@ -0,0 +1,238 @@
+#include "rope.hpp"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // appending short texts to a short piece creates one new buffer instead of a new piece,
+    // so text typed in small portions does not become a treap of tiny pieces
+    constexpr size_t coalesce_limit = 256;
+
+    std::uint64_t next_priority()
+    {
+        // splitmix64
+        thread_local std::uint64_t state = 0;
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+} // namespace
+
+Rope::Rope(std::string text)
+{
+    append(std::move(text));
+}
+
+Rope::NodePtr Rope::make_node(const Node& piece, NodePtr left, NodePtr right)
+{
+    const size_t subtree_total = total(left) + piece.length + total(right);
+    return std::make_shared<const Node>(Node{piece.buffer, piece.offset, piece.length, subtree_total, piece.priority, std::move(left), std::move(right)});
+}
+
+Rope::NodePtr Rope::make_leaf(std::shared_ptr<const std::string> buffer, size_t offset, size_t length)
+{
+    return std::make_shared<const Node>(Node{std::move(buffer), offset, length, length, next_priority(), nullptr, nullptr});
+}
+
+Rope::NodePtr Rope::merge(const NodePtr& left, const NodePtr& right)
+{
+    if (!left)
+        return right;
+    if (!right)
+        return left;
+
+    if (left->priority > right->priority)
+        return make_node(*left, left->left, merge(left->right, right));
+
+    return make_node(*right, merge(left, right->left), right->right);
+}
+
+// first: the first pos characters, second: the rest
+std::pair<Rope::NodePtr, Rope::NodePtr> Rope::split(const NodePtr& node, size_t pos)
+{
+    if (!node)
+        return {};
+
+    const size_t left_total = total(node->left);
+
+    if (pos <= left_total)
+    {
+        auto [first, second] = split(node->left, pos);
+        return {std::move(first), make_node(*node, std::move(second), node->right)};
+    }
+
+    if (pos >= left_total + node->length)
+    {
+        auto [first, second] = split(node->right, pos - left_total - node->length);
+        return {make_node(*node, node->left, std::move(first)), std::move(second)};
+    }
+
+    // the piece itself is cut - both halves keep sharing its buffer
+    const size_t cut = pos - left_total;
+    return {merge(node->left, make_leaf(node->buffer, node->offset, cut)),
+        merge(make_leaf(node->buffer, node->offset + cut, node->length - cut), node->right)};
+}
+
+void Rope::insert(size_t pos, std::string text)
+{
+    if (pos > size())
+        throw std::out_of_range("Rope::insert - position out of range");
+
+    if (text.empty())
+        return;
+
+    auto [left, right] = split(root_, pos);
+
+    if (left && text.size() < coalesce_limit)
+    {
+        const Node* last = left.get();
+        while (last->right)
+            last = last->right.get();
+
+        if (last->length + text.size() <= coalesce_limit)
+        {
+            std::string joined = last->buffer->substr(last->offset, last->length) + text;
+            text = std::move(joined);
+            left = split(left, left->total - last->length).first;
+        }
+    }
+
+    const size_t length = text.size();
+    auto piece = make_leaf(std::make_shared<const std::string>(std::move(text)), 0, length);
+    root_ = merge(merge(left, piece), right);
+}
+
+void Rope::insert(size_t pos, std::shared_ptr<const std::string> buffer)
+{
+    if (!buffer || buffer->size() < coalesce_limit)
+    {
+        insert(pos, buffer ? *buffer : std::string{});
+        return;
+    }
+
+    if (pos > size())
+        throw std::out_of_range("Rope::insert - position out of range");
+
+    const size_t length = buffer->size();
+    auto [left, right] = split(root_, pos);
+    root_ = merge(merge(left, make_leaf(std::move(buffer), 0, length)), right);
+}
+
+void Rope::erase(size_t pos, size_t count)
+{
+    if (pos > size())
+        throw std::out_of_range("Rope::erase - position out of range");
+
+    count = std::min(count, size() - pos);
+    if (count == 0)
+        return;
+
+    auto [left, rest] = split(root_, pos);
+    root_ = merge(left, split(rest, count).second);
+}
+
+void Rope::replace(size_t pos, size_t count, std::string text)
+{
+    erase(pos, count);
+    insert(pos, std::move(text));
+}
+
+std::string Rope::substr(size_t pos, size_t count) const
+{
+    if (pos > size())
+        throw std::out_of_range("Rope::substr - position out of range");
+
+    count = std::min(count, size() - pos);
+
+    std::string result;
+    result.reserve(count);
+
+    // walks only the pieces overlapping [pos, pos + count)
+    auto collect = [&](auto& self, const NodePtr& node, size_t node_pos) -> void {
+        if (!node || result.size() == count)
+            return;
+
+        const size_t left_total = total(node->left);
+        const size_t piece_pos = node_pos + left_total;
+
+        if (pos < piece_pos)
+            self(self, node->left, node_pos);
+
+        const size_t end = pos + count;
+        if (piece_pos < end && pos < piece_pos + node->length)
+        {
+            const size_t from = std::max(pos, piece_pos);
+            const size_t to = std::min(end, piece_pos + node->length);
+            result.append(*node->buffer, node->offset + (from - piece_pos), to - from);
+        }
+
+        if (end > piece_pos + node->length)
+            self(self, node->right, piece_pos + node->length);
+    };
+    collect(collect, root_, 0);
+
+    return result;
+}
+
+size_t Rope::difference_size(const Rope& other) const
+{
+    // Nodes of both ropes are visited in order of decreasing priority. A subtree shared by the
+    // ropes has the same root node in both; all its ancestors have higher priorities, so the
+    // root is reached from both sides before it is visited - and skipped with its subtree.
+    // Nodes rebuilt by an edit are new objects, but keep the piece & priority of the original.
+    struct Visit
+    {
+        const Node* node;
+        int side;
+
+        bool operator<(const Visit& other) const
+        {
+            return node->priority < other.node->priority;
+        }
+    };
+
+    std::priority_queue<Visit> visits;
+    std::unordered_map<const Node*, int> reached; // sides a node was reached from
+    std::map<std::tuple<std::uint64_t, const std::string*, size_t>, std::pair<size_t, int>> pieces; // -> length, sides
+
+    auto reach = [&](const NodePtr& node, int side) {
+        if (!node)
+            return;
+        reached[node.get()] |= side;
+        visits.push({node.get(), side});
+    };
+
+    reach(root_, 1);
+    reach(other.root_, 2);
+
+    while (!visits.empty())
+    {
+        const Visit visit = visits.top();
+        visits.pop();
+
+        if (reached[visit.node] == 3)
+            continue;
+
+        auto& piece = pieces[{visit.node->priority, visit.node->buffer.get(), visit.node->offset}];
+        piece.first = visit.node->length;
+        piece.second |= visit.side;
+
+        reach(visit.node->left, visit.side);
+        reach(visit.node->right, visit.side);
+    }
+
+    size_t size = 0;
+    for (const auto& [key, piece] : pieces)
+    {
+        if (piece.second != 3)
+            size += piece.first;
+    }
+    return size;
+}
@@ -0,0 +1,115 @@
+#ifndef ROPE_HPP
+#define ROPE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Persistent rope - text kept as an implicit treap of pieces, each piece a slice of an
+// immutable, shared buffer. Insert, erase and replace are O(log n): they rebuild only the
+// nodes on the changed paths and share the rest, so copying a Rope is O(1) and copies
+// never affect each other (cheap snapshots).
+class Rope
+{
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node
+    {
+        std::shared_ptr<const std::string> buffer;
+        size_t offset;
+        size_t length;
+        size_t total; // length of the text of the whole subtree
+        std::uint64_t priority;
+        NodePtr left;
+        NodePtr right;
+    };
+
+    NodePtr root_;
+
+public:
+    Rope() = default;
+
+    explicit Rope(std::string text);
+
+    size_t size() const
+    {
+        return root_ ? root_->total : 0;
+    }
+
+    bool empty() const
+    {
+        return !root_;
+    }
+
+    void insert(size_t pos, std::string text);
+
+    // the rope keeps a reference to the buffer instead of copying it (short texts are copied)
+    void insert(size_t pos, std::shared_ptr<const std::string> buffer);
+
+    void append(std::string text)
+    {
+        insert(size(), std::move(text));
+    }
+
+    void append(std::shared_ptr<const std::string> buffer)
+    {
+        insert(size(), std::move(buffer));
+    }
+
+    void erase(size_t pos, size_t count);
+
+    void replace(size_t pos, size_t count, std::string text);
+
+    void clear()
+    {
+        root_.reset();
+    }
+
+    std::string str() const
+    {
+        return substr(0, size());
+    }
+
+    // like std::string::substr - count is clipped to the end of the text
+    std::string substr(size_t pos, size_t count) const;
+
+    // Length of the pieces that only one of the two ropes holds - the text kept alive by
+    // this rope or other alone when both stay alive (e.g. snapshots before and after an edit).
+    // O(d log d) for d pieces on the paths the ropes do not share.
+    size_t difference_size(const Rope& other) const;
+
+    // calls f(std::string_view) for consecutive pieces of the text - no copy is made
+    template <typename F>
+    void for_each_chunk(F&& f) const
+    {
+        for_each_chunk(root_, f);
+    }
+
+private:
+    template <typename F>
+    static void for_each_chunk(const NodePtr& node, F& f)
+    {
+        if (!node)
+            return;
+
+        for_each_chunk(node->left, f);
+        f(std::string_view{*node->buffer}.substr(node->offset, node->length));
+        for_each_chunk(node->right, f);
+    }
+
+    static size_t total(const NodePtr& node)
+    {
+        return node ? node->total : 0;
+    }
+
+    static NodePtr make_node(const Node& piece, NodePtr left, NodePtr right);
+    static NodePtr make_leaf(std::shared_ptr<const std::string> buffer, size_t offset, size_t length);
+    static NodePtr merge(const NodePtr& left, const NodePtr& right);
+    static std::pair<NodePtr, NodePtr> split(const NodePtr& node, size_t pos);
+};
+
+#endif // ROPE_HPP
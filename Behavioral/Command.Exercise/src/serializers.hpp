@@ -1,6 +1,21 @@
 #ifndef SERIALIZERS_HPP
 #define SERIALIZERS_HPP
 
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// text stored in pieces - e.g. a Rope
+template <typename T>
+concept ChunkedText = requires(const T& text) {
+    { text.size() } -> std::convertible_to<size_t>;
+    text.for_each_chunk([](std::string_view) {});
+};
+
 template <typename TStream>
 class StreamOutputSerializer
 {
@@ -14,9 +29,19 @@ public:
     template <typename... TArgs>
     bool operator()(const TArgs&... args)
     {
-        ((out_stream_ << args), ...);
+        (write(args), ...);
         return !out_stream_.fail();
     }
+
+private:
+    template <typename T>
+    void write(const T& value)
+    {
+        if constexpr (ChunkedText<T>)
+            value.for_each_chunk([this](std::string_view chunk) { out_stream_ << chunk; });
+        else
+            out_stream_ << value;
+    }
 };
 
 template <typename TStream>
@@ -37,4 +62,164 @@ public:
     }
 };
 
-#endif
\ No newline at end of file
+// Binary archive appending to a byte buffer (std::string or std::vector<char>). Strings are
+// stored with a 64-bit length prefix, so any bytes - whitespace included - round trip;
+// trivially copyable values are stored as they are in memory. The space for all arguments
+// of a call is reserved up front, so each value is copied with a single memcpy.
+template <typename TBuffer>
+class BinaryOutputSerializer
+{
+    TBuffer& buffer_;
+
+public:
+    BinaryOutputSerializer(TBuffer& buffer)
+        : buffer_{buffer}
+    { }
+
+    template <typename... TArgs>
+    bool operator()(const TArgs&... args)
+    {
+        buffer_.reserve(buffer_.size() + (encoded_size(args) + ... + 0));
+        (write(args), ...);
+        return true;
+    }
+
+private:
+    template <typename T>
+    static size_t encoded_size(const T& value)
+    {
+        if constexpr (ChunkedText<T> || std::is_convertible_v<const T&, std::string_view>)
+            return sizeof(std::uint64_t) + value.size();
+        else
+            return sizeof(T);
+    }
+
+    void append(const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void write(const T& value)
+    {
+        if constexpr (ChunkedText<T>)
+        {
+            const std::uint64_t size = value.size();
+            append(&size, sizeof(size));
+            value.for_each_chunk([this](std::string_view chunk) { append(chunk.data(), chunk.size()); });
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            const std::string_view text = value;
+            const std::uint64_t size = text.size();
+            append(&size, sizeof(size));
+            append(text.data(), text.size());
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "BinaryOutputSerializer stores strings & trivially copyable values");
+            append(&value, sizeof(value));
+        }
+    }
+};
+
+// Reads what BinaryOutputSerializer wrote - the buffer is read in place, not copied.
+// Returns false when the buffer ends too early.
+template <typename TBuffer>
+class BinaryInputSerializer
+{
+    const TBuffer& buffer_;
+    size_t position_{};
+
+public:
+    BinaryInputSerializer(const TBuffer& buffer)
+        : buffer_{buffer}
+    { }
+
+    template <typename... TArgs>
+    bool operator()(TArgs&... args)
+    {
+        return (read(args) && ...);
+    }
+
+private:
+    bool read_bytes(void* data, size_t size)
+    {
+        if (size > buffer_.size() - position_)
+            return false;
+
+        std::memcpy(data, buffer_.data() + position_, size);
+        position_ += size;
+        return true;
+    }
+
+    bool read(std::string& text)
+    {
+        std::uint64_t size{};
+        if (!read_bytes(&size, sizeof(size)) || size > buffer_.size() - position_)
+            return false;
+
+        text.assign(buffer_.data() + position_, size);
+        position_ += size;
+        return true;
+    }
+
+    template <typename T>
+    bool read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "BinaryInputSerializer reads strings & trivially copyable values");
+        return read_bytes(&value, sizeof(value));
+    }
+};
+
+// How an archive is attached to the bytes of a snapshot: stream serializers work on
+// a std::stringstream, binary ones directly on the bytes.
+template <template <typename> class Serializer>
+struct SerializerTraits
+{
+    template <typename Save>
+    static std::string save(Save&& save_to)
+    {
+        std::stringstream stream;
+        {
+            Serializer archive(stream);
+            save_to(archive);
+        }
+        return stream.str();
+    }
+
+    template <typename Load>
+    static void load(const std::string& bytes, Load&& load_from)
+    {
+        std::stringstream stream{bytes};
+        Serializer archive(stream);
+        load_from(archive);
+    }
+};
+
+template <>
+struct SerializerTraits<BinaryOutputSerializer>
+{
+    template <typename Save>
+    static std::string save(Save&& save_to)
+    {
+        std::string bytes;
+        BinaryOutputSerializer archive(bytes);
+        save_to(archive);
+        return bytes;
+    }
+};
+
+template <>
+struct SerializerTraits<BinaryInputSerializer>
+{
+    template <typename Load>
+    static void load(const std::string& bytes, Load&& load_from)
+    {
+        BinaryInputSerializer archive(bytes);
+        load_from(archive);
+    }
+};
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef BATCH_ANALYZER_HPP
+#define BATCH_ANALYZER_HPP
+
+#include "bounded_queue.hpp"
+#include "data_loader.hpp"
+#include "statistics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Version_1
+{
+    template <typename TResults>
+    struct BasicFileResults
+    {
+        size_t index; // position in the list of files
+        std::string file_name;
+        TResults results;
+        std::exception_ptr error; // set when the file could not be loaded or analyzed
+    };
+
+    // Analyzes a list of files as a pipeline: reader threads map and parse the next files while
+    // compute workers run the statistics on files already loaded. At most max_queued_files parsed
+    // files wait between the stages, so memory stays bounded however long the list is.
+    // Workers are plain threads of the batch, not a ThreadPool shared with ParallelExecution -
+    // a worker blocked on the queue can never starve the tasks it would wait for.
+    // The statistics are any callable that fills TResults from the values of a file.
+    template <typename TResults>
+    class BasicBatchAnalyzer
+    {
+    public:
+        using Calculate = std::function<void(const Data&, TResults&)>;
+        using FileResults = BasicFileResults<TResults>;
+        using Callback = std::function<void(const FileResults&)>;
+
+    private:
+        Calculate calculate_;
+        size_t reader_count_;
+        size_t worker_count_;
+        size_t max_queued_files_;
+
+        struct LoadedFile
+        {
+            size_t index;
+            Data data;
+            std::exception_ptr error;
+        };
+
+    public:
+        explicit BasicBatchAnalyzer(Calculate calculate, size_t reader_count = 2,
+            size_t worker_count = std::max(1u, std::thread::hardware_concurrency()), size_t max_queued_files = 4)
+            : calculate_{std::move(calculate)}
+            , reader_count_{std::max<size_t>(reader_count, 1)}
+            , worker_count_{std::max<size_t>(worker_count, 1)}
+            , max_queued_files_{max_queued_files}
+        {
+        }
+
+        // Blocks until all files are done. on_file_done is called for every file as soon as
+        // it completes - in completion order, from worker threads, one call at a time.
+        // An exception thrown by on_file_done stops the batch and is rethrown here.
+        void run(const std::vector<std::string>& file_names, const Callback& on_file_done) const
+        {
+            BoundedQueue<LoadedFile> loaded_files{max_queued_files_};
+            std::atomic<size_t> next_file{0};
+            std::atomic<bool> stopped{false};
+
+            auto read = [&] {
+                for (size_t i = next_file++; i < file_names.size() && !stopped; i = next_file++)
+                {
+                    LoadedFile loaded{i, {}, nullptr};
+                    try
+                    {
+                        loaded.data = DataLoader::load_file(file_names[i]);
+                    }
+                    catch (...)
+                    {
+                        loaded.error = std::current_exception();
+                    }
+
+                    loaded_files.push(std::move(loaded));
+                }
+            };
+
+            std::mutex callback_mtx;
+            std::exception_ptr callback_error;
+
+            auto compute = [&] {
+                while (auto loaded = loaded_files.pop())
+                {
+                    if (stopped)
+                        continue; // drained, so no reader stays blocked on a full queue
+
+                    FileResults file_results{loaded->index, file_names[loaded->index], {}, loaded->error};
+                    if (!file_results.error)
+                    {
+                        try
+                        {
+                            calculate_(loaded->data, file_results.results);
+                        }
+                        catch (...)
+                        {
+                            file_results.error = std::current_exception();
+                        }
+                    }
+
+                    std::lock_guard lk{callback_mtx};
+                    if (stopped)
+                        continue;
+
+                    try
+                    {
+                        on_file_done(file_results);
+                    }
+                    catch (...)
+                    {
+                        callback_error = std::current_exception();
+                        stopped = true;
+                    }
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (size_t i = 0; i < std::min(worker_count_, file_names.size()); ++i)
+                workers.emplace_back(compute);
+
+            std::vector<std::thread> readers;
+            for (size_t i = 0; i < std::min(reader_count_, file_names.size()); ++i)
+                readers.emplace_back(read);
+
+            for (auto& reader : readers)
+                reader.join();
+
+            loaded_files.close();
+
+            for (auto& worker : workers)
+                worker.join();
+
+            if (callback_error)
+                std::rethrow_exception(callback_error);
+        }
+    };
+
+    using FileResults = BasicFileResults<Results>;
+
+    class BatchAnalyzer : public BasicBatchAnalyzer<Results>
+    {
+    public:
+        explicit BatchAnalyzer(std::shared_ptr<Statistics> statistics, size_t reader_count = 2,
+            size_t worker_count = std::max(1u, std::thread::hardware_concurrency()), size_t max_queued_files = 4)
+            : BasicBatchAnalyzer{[statistics = std::move(statistics)](const Data& data, Results& results) {
+                                     statistics->calculate(data, results);
+                                 },
+                reader_count, worker_count, max_queued_files}
+        {
+        }
+    };
+}
+
+#endif // BATCH_ANALYZER_HPP
@@ -0,0 +1,92 @@
+#include "batch_analyzer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Version_1;
+
+namespace
+{
+    constexpr size_t file_count = 8;
+    constexpr size_t values_per_file = 1 << 18;
+
+    // written once, removed when the benchmark binary exits
+    struct BenchmarkFiles
+    {
+        std::vector<std::string> names;
+
+        BenchmarkFiles()
+        {
+            std::mt19937_64 rnd_gen{42};
+            std::uniform_real_distribution<double> distribution{-1000.0, 1000.0};
+
+            for (size_t i = 0; i < file_count; ++i)
+            {
+                names.push_back("batch_analyzer_benchmarks_" + std::to_string(i) + ".dat");
+                std::ofstream fout{names.back()};
+                for (size_t j = 0; j < values_per_file; ++j)
+                    fout << distribution(rnd_gen) << "\n";
+            }
+        }
+
+        ~BenchmarkFiles()
+        {
+            for (const auto& name : names)
+                std::remove(name.c_str());
+        }
+    };
+
+    const std::vector<std::string>& file_names()
+    {
+        static BenchmarkFiles files;
+        return files.names;
+    }
+
+    std::shared_ptr<Statistics> create_statistics()
+    {
+        return std::make_shared<StatGroup>(
+            std::initializer_list<std::shared_ptr<Statistics>>{std::make_shared<Average>(), std::make_shared<MinMax>(), std::make_shared<Sum>()},
+            ExecutionMode::fused);
+    }
+
+    // previous behaviour - load, then calculate, one file after another
+    void BM_Batch_Sequential(benchmark::State& state)
+    {
+        const auto statistics = create_statistics();
+        const auto& names = file_names();
+
+        for (auto _ : state)
+        {
+            for (const auto& name : names)
+            {
+                const auto data = DataLoader::load_file(name);
+                Results results;
+                statistics->calculate(data, results);
+                benchmark::DoNotOptimize(results.data());
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * file_count * values_per_file);
+    }
+
+    void BM_Batch_Pipeline(benchmark::State& state)
+    {
+        BatchAnalyzer batch{create_statistics(), static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1))};
+        const auto& names = file_names();
+
+        for (auto _ : state)
+        {
+            batch.run(names, [](const FileResults& file) { benchmark::DoNotOptimize(file.results.data()); });
+        }
+
+        state.SetItemsProcessed(state.iterations() * file_count * values_per_file);
+    }
+} // namespace
+
+BENCHMARK(BM_Batch_Sequential)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Batch_Pipeline)->Args({1, 1})->Args({2, 2})->Args({4, 2})->Unit(benchmark::kMillisecond)->UseRealTime();
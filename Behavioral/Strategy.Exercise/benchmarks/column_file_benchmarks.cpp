@@ -0,0 +1,116 @@
+#include "column_file.hpp"
+#include "data_loader.hpp"
+#include "statistics.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Version_1;
+
+namespace
+{
+    constexpr size_t value_count = 1 << 22;
+
+    const char* const text_file_name = "column_file_benchmarks.dat";
+    const char* const column_file_name = "column_file_benchmarks.col";
+
+    // written once, removed when the benchmark binary exits
+    struct BenchmarkFiles
+    {
+        BenchmarkFiles()
+        {
+            std::mt19937_64 rnd_gen{42};
+            std::uniform_real_distribution<double> distribution{-1000.0, 1000.0};
+
+            std::vector<double> values(value_count);
+            for (auto& value : values)
+                value = distribution(rnd_gen);
+
+            std::ofstream fout{text_file_name};
+            for (const auto& value : values)
+                fout << value << "\n";
+
+            ColumnFile::write(column_file_name, values);
+        }
+
+        ~BenchmarkFiles()
+        {
+            std::remove(text_file_name);
+            std::remove(column_file_name);
+        }
+    };
+
+    void prepare_files()
+    {
+        static BenchmarkFiles files;
+    }
+
+    StatGroup create_statistics()
+    {
+        return StatGroup{{std::make_shared<Average>(), std::make_shared<MinMax>(), std::make_shared<Sum>()}, ExecutionMode::fused};
+    }
+
+    void BM_Analyze_TextFile(benchmark::State& state)
+    {
+        prepare_files();
+        const auto statistics = create_statistics();
+
+        for (auto _ : state)
+        {
+            const auto data = DataLoader::load_file(text_file_name);
+            Results results;
+            statistics.calculate(data, results);
+            benchmark::DoNotOptimize(results.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * value_count);
+    }
+
+    void BM_Analyze_ColumnFile_Payload(benchmark::State& state)
+    {
+        prepare_files();
+        const auto statistics = create_statistics();
+
+        for (auto _ : state)
+        {
+            ColumnFile file{column_file_name};
+            Results results;
+            statistics.calculate(file.values(), results);
+            benchmark::DoNotOptimize(results.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * value_count);
+    }
+
+    void BM_Analyze_ColumnFile_ChunkSummaries(benchmark::State& state)
+    {
+        prepare_files();
+        const auto statistics = create_statistics();
+
+        for (auto _ : state)
+        {
+            ColumnFile file{column_file_name};
+            auto accumulator = statistics.create_accumulator();
+            const auto summaries = file.chunk_summaries();
+            for (size_t i = 0; i < summaries.size(); ++i)
+            {
+                const auto chunk = file.chunk(i);
+                accumulator->update_chunk(summaries[i], chunk.data(), chunk.data() + chunk.size());
+            }
+
+            Results results;
+            accumulator->get_results(results);
+            benchmark::DoNotOptimize(results.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * value_count);
+    }
+} // namespace
+
+BENCHMARK(BM_Analyze_TextFile)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Analyze_ColumnFile_Payload)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Analyze_ColumnFile_ChunkSummaries)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,68 @@
+#include "data_analyzer.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Version_1;
+
+namespace
+{
+    constexpr size_t initial_size = 1 << 23;
+    constexpr size_t append_size = 1000;
+
+    std::vector<double> generate_data(size_t size)
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_real_distribution<double> distribution{-1000.0, 1000.0};
+
+        std::vector<double> data(size);
+        std::generate(data.begin(), data.end(), [&] { return distribution(rnd_gen); });
+        return data;
+    }
+
+    DataAnalyzer create_analyzer()
+    {
+        DataAnalyzer analyzer{std::make_shared<StatGroup>(
+            std::initializer_list<std::shared_ptr<Statistics>>{std::make_shared<Average>(), std::make_shared<MinMax>(), std::make_shared<Sum>()},
+            ExecutionMode::fused)};
+        analyzer.append(generate_data(initial_size));
+        analyzer.calculate();
+        return analyzer;
+    }
+
+    // previous behaviour - every change of data rescans all of it
+    void BM_Append_FullRecalculation(benchmark::State& state)
+    {
+        auto analyzer = create_analyzer();
+        const auto new_values = generate_data(append_size);
+
+        for (auto _ : state)
+        {
+            analyzer.append(new_values);
+            analyzer.calculate();
+            benchmark::DoNotOptimize(analyzer.results().data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * append_size);
+    }
+
+    void BM_Append_Incremental(benchmark::State& state)
+    {
+        auto analyzer = create_analyzer();
+        const auto new_values = generate_data(append_size);
+
+        for (auto _ : state)
+        {
+            analyzer.append(new_values);
+            benchmark::DoNotOptimize(analyzer.results().data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * append_size);
+    }
+} // namespace
+
+BENCHMARK(BM_Append_FullRecalculation)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Append_Incremental)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,64 @@
+#include "data_loader.hpp"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string generate_text(size_t count)
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_real_distribution<double> distribution{-1000.0, 1000.0};
+
+        std::string text;
+        for (size_t i = 0; i < count; ++i)
+            text.append(std::to_string(distribution(rnd_gen))).append("\n");
+        return text;
+    }
+
+    // previous implementation of DataAnalyzer::load_data
+    void BM_Parse_IStream(benchmark::State& state)
+    {
+        const std::string text = generate_text(state.range(0));
+
+        for (auto _ : state)
+        {
+            std::istringstream in{text};
+            std::vector<double> data;
+            double d;
+            while (in >> d)
+                data.push_back(d);
+            benchmark::DoNotOptimize(data.data());
+        }
+
+        state.SetBytesProcessed(state.iterations() * text.size());
+    }
+
+    void BM_Parse_FromChars(benchmark::State& state)
+    {
+        const std::string text = generate_text(state.range(0));
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(DataLoader::parse(text).data());
+
+        state.SetBytesProcessed(state.iterations() * text.size());
+    }
+
+    void BM_Parse_FromChars_Parallel(benchmark::State& state)
+    {
+        const std::string text = generate_text(1 << 22);
+        ThreadPool thread_pool(state.range(0));
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(DataLoader::parse(text, &thread_pool).data());
+
+        state.SetBytesProcessed(state.iterations() * text.size());
+    }
+} // namespace
+
+BENCHMARK(BM_Parse_IStream)->Arg(1 << 22);
+BENCHMARK(BM_Parse_FromChars)->Arg(1 << 22);
+BENCHMARK(BM_Parse_FromChars_Parallel)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
@@ -0,0 +1,75 @@
+#include "distribution_statistics.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Version_1;
+
+namespace
+{
+    // latency-like data - log-normal
+    std::vector<double> generate_data(size_t size)
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::lognormal_distribution<double> distribution{3.0, 1.0};
+
+        std::vector<double> data(size);
+        std::generate(data.begin(), data.end(), [&] { return distribution(rnd_gen); });
+        return data;
+    }
+
+    // exact quantiles need a copy of all the data
+    void BM_Quantiles_NthElement(benchmark::State& state)
+    {
+        const auto data = generate_data(state.range(0));
+
+        for (auto _ : state)
+        {
+            auto copy = data;
+            for (const double q : {0.5, 0.9, 0.99})
+            {
+                auto nth = copy.begin() + static_cast<size_t>(q * (copy.size() - 1));
+                std::nth_element(copy.begin(), nth, copy.end());
+                benchmark::DoNotOptimize(*nth);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void run_statistics(benchmark::State& state, const Statistics& statistics)
+    {
+        const auto data = generate_data(state.range(0));
+
+        for (auto _ : state)
+        {
+            Results results;
+            statistics.calculate(data, results);
+            benchmark::DoNotOptimize(results.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_Quantiles_KllSketch(benchmark::State& state)
+    {
+        run_statistics(state, Quantiles{0.5, 0.9, 0.99});
+    }
+
+    void BM_Histogram_FixedBuckets(benchmark::State& state)
+    {
+        run_statistics(state, Histogram{0.0, 1000.0, 100});
+    }
+
+    void BM_Histogram_LogLinear(benchmark::State& state)
+    {
+        run_statistics(state, LogLinearHistogram{0.01, 10'000.0});
+    }
+} // namespace
+
+BENCHMARK(BM_Quantiles_NthElement)->Arg(1 << 22);
+BENCHMARK(BM_Quantiles_KllSketch)->Arg(1 << 22);
+BENCHMARK(BM_Histogram_FixedBuckets)->Arg(1 << 22);
+BENCHMARK(BM_Histogram_LogLinear)->Arg(1 << 22);
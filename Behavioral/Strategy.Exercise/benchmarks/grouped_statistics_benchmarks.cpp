@@ -0,0 +1,82 @@
+#include "grouped_statistics.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Version_1;
+
+namespace
+{
+    constexpr size_t pair_count = 1 << 22;
+
+    struct KeyValues
+    {
+        std::vector<std::string> keys;
+        std::vector<double> values;
+    };
+
+    KeyValues generate_data(size_t group_count)
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_int_distribution<size_t> key_distribution{0, group_count - 1};
+        std::uniform_real_distribution<double> value_distribution{-1000.0, 1000.0};
+
+        KeyValues data;
+        for (size_t i = 0; i < pair_count; ++i)
+        {
+            data.keys.push_back("key_" + std::to_string(key_distribution(rnd_gen)));
+            data.values.push_back(value_distribution(rnd_gen));
+        }
+        return data;
+    }
+
+    StatGroup create_statistics()
+    {
+        return StatGroup{{std::make_shared<Average>(), std::make_shared<MinMax>(), std::make_shared<Sum>()}, ExecutionMode::fused};
+    }
+
+    // node-based map, one accumulator update per value
+    void BM_Grouped_UnorderedMap(benchmark::State& state)
+    {
+        const auto data = generate_data(state.range(0));
+        const auto statistics = create_statistics();
+
+        for (auto _ : state)
+        {
+            std::unordered_map<std::string, AccumulatorPtr> groups;
+            for (size_t i = 0; i < pair_count; ++i)
+            {
+                auto& accumulator = groups[data.keys[i]];
+                if (!accumulator)
+                    accumulator = statistics.create_accumulator();
+                accumulator->update(&data.values[i], &data.values[i] + 1);
+            }
+            benchmark::DoNotOptimize(groups.size());
+        }
+
+        state.SetItemsProcessed(state.iterations() * pair_count);
+    }
+
+    void BM_Grouped_GroupedStatistics(benchmark::State& state)
+    {
+        const auto data = generate_data(state.range(0));
+        const auto statistics = create_statistics();
+
+        for (auto _ : state)
+        {
+            GroupedStatistics grouped{statistics};
+            for (size_t i = 0; i < pair_count; ++i)
+                grouped.add(data.keys[i], data.values[i]);
+            benchmark::DoNotOptimize(grouped.results().data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * pair_count);
+    }
+} // namespace
+
+BENCHMARK(BM_Grouped_UnorderedMap)->Arg(1'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Grouped_GroupedStatistics)->Arg(1'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,114 @@
+#include "execution_policy.hpp"
+#include "stat_kernels.hpp"
+#include "statistics.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+    std::vector<double> generate_data(size_t size)
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_real_distribution<double> distribution{-1000.0, 1000.0};
+
+        std::vector<double> data(size);
+        std::generate(data.begin(), data.end(), [&] { return distribution(rnd_gen); });
+        return data;
+    }
+
+    // previous implementation of Sum & Average
+    void BM_Sum_StdAccumulate(benchmark::State& state)
+    {
+        const auto data = generate_data(state.range(0));
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(std::accumulate(data.begin(), data.end(), 0.0));
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+    }
+
+    void BM_Sum_Kernel(benchmark::State& state)
+    {
+        const auto data = generate_data(state.range(0));
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(StatKernels::sum(data.data(), data.size()));
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+        state.SetLabel(StatKernels::uses_avx2() ? "avx2" : "scalar");
+    }
+
+    // previous implementation of MinMax
+    void BM_MinMax_StdMinMaxElement(benchmark::State& state)
+    {
+        const auto data = generate_data(state.range(0));
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(*std::min_element(data.begin(), data.end()));
+            benchmark::DoNotOptimize(*std::max_element(data.begin(), data.end()));
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+    }
+
+    void BM_MinMax_Kernel(benchmark::State& state)
+    {
+        const auto data = generate_data(state.range(0));
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(StatKernels::min_max(data.data(), data.size()));
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+        state.SetLabel(StatKernels::uses_avx2() ? "avx2" : "scalar");
+    }
+
+    template <Version_1::ExecutionMode Mode>
+    void BM_StatGroup(benchmark::State& state)
+    {
+        using namespace Version_1;
+
+        const auto data = generate_data(state.range(0));
+        StatGroup stats{{std::make_shared<Average>(), std::make_shared<MinMax>(), std::make_shared<Sum>()}, Mode};
+
+        for (auto _ : state)
+        {
+            Results results;
+            stats.calculate(data, results);
+            benchmark::DoNotOptimize(results.data());
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+    }
+
+    void BM_StatGroup_ParallelExecution(benchmark::State& state)
+    {
+        using namespace Version_1;
+
+        const auto data = generate_data(1 << 24);
+        StatGroup stats{{std::make_shared<Average>(), std::make_shared<MinMax>(), std::make_shared<Sum>()}};
+        ParallelExecution execution{std::make_shared<ThreadPool>(state.range(0))};
+
+        for (auto _ : state)
+        {
+            Results results;
+            execution.run(stats, data, results);
+            benchmark::DoNotOptimize(results.data());
+        }
+
+        state.SetBytesProcessed(state.iterations() * data.size() * sizeof(double));
+    }
+} // namespace
+
+BENCHMARK(BM_Sum_StdAccumulate)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(BM_Sum_Kernel)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(BM_MinMax_StdMinMaxElement)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(BM_MinMax_Kernel)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK_TEMPLATE(BM_StatGroup, Version_1::ExecutionMode::sequential)->Arg(1 << 24);
+BENCHMARK_TEMPLATE(BM_StatGroup, Version_1::ExecutionMode::fused)->Arg(1 << 24);
+BENCHMARK(BM_StatGroup_ParallelExecution)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
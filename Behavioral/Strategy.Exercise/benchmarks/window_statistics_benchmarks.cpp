@@ -0,0 +1,68 @@
+#include "window_statistics.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Version_1;
+
+namespace
+{
+    constexpr size_t series_length = 1 << 16;
+
+    std::vector<double> generate_data(size_t size)
+    {
+        std::mt19937_64 rnd_gen{42};
+        std::uniform_real_distribution<double> distribution{-1000.0, 1000.0};
+
+        std::vector<double> data(size);
+        std::generate(data.begin(), data.end(), [&] { return distribution(rnd_gen); });
+        return data;
+    }
+
+    // statistics recomputed over a copy of the window after every sample
+    void BM_Window_Recompute(benchmark::State& state)
+    {
+        const auto data = generate_data(series_length);
+        const size_t window_size = state.range(0);
+        StatGroup stats{{std::make_shared<Average>(), std::make_shared<MinMax>(), std::make_shared<Sum>()}, ExecutionMode::fused};
+
+        for (auto _ : state)
+        {
+            for (size_t i = 1; i <= data.size(); ++i)
+            {
+                const size_t first = i > window_size ? i - window_size : 0;
+                const Data window(data.begin() + first, data.begin() + i);
+                Results results;
+                stats.calculate(window, results);
+                benchmark::DoNotOptimize(results.data());
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * data.size());
+    }
+
+    void BM_Window_Sliding(benchmark::State& state)
+    {
+        const auto data = generate_data(series_length);
+        StatGroup stats{{std::make_shared<Average>(), std::make_shared<MinMax>(), std::make_shared<Sum>()}, ExecutionMode::fused};
+
+        for (auto _ : state)
+        {
+            auto window = SlidingWindow::count_based(stats, state.range(0));
+            for (const double value : data)
+            {
+                window.push(value);
+                Results results;
+                window.get_results(results);
+                benchmark::DoNotOptimize(results.data());
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * data.size());
+    }
+} // namespace
+
+BENCHMARK(BM_Window_Recompute)->Arg(100)->Arg(10'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Window_Sliding)->Arg(100)->Arg(10'000)->Unit(benchmark::kMillisecond);
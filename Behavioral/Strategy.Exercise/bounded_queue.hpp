@@ -0,0 +1,72 @@
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+
+// Multi-producer, multi-consumer queue with fixed capacity - producers wait when it is full,
+// which bounds the memory of a pipeline whose consumers are slower than its producers
+template <typename T>
+class BoundedQueue
+{
+    std::queue<T> items_;
+    size_t capacity_;
+    std::mutex mtx_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    bool closed_ = false;
+
+public:
+    explicit BoundedQueue(size_t capacity)
+        : capacity_{std::max<size_t>(capacity, 1)}
+    {
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    void push(T item)
+    {
+        {
+            std::unique_lock lk{mtx_};
+            not_full_.wait(lk, [this] { return items_.size() < capacity_; });
+            items_.push(std::move(item));
+        }
+        not_empty_.notify_one();
+    }
+
+    // std::nullopt once the queue is closed and empty
+    std::optional<T> pop()
+    {
+        std::optional<T> item;
+
+        {
+            std::unique_lock lk{mtx_};
+            not_empty_.wait(lk, [this] { return closed_ || !items_.empty(); });
+
+            if (items_.empty())
+                return item;
+
+            item = std::move(items_.front());
+            items_.pop();
+        }
+        not_full_.notify_one();
+
+        return item;
+    }
+
+    // no more items will be pushed
+    void close()
+    {
+        {
+            std::lock_guard lk{mtx_};
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+    }
+};
+
+#endif // BOUNDED_QUEUE_HPP
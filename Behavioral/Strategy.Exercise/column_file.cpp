@@ -0,0 +1,110 @@
+#include "column_file.hpp"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+static_assert(std::endian::native == std::endian::little, "column files store little-endian doubles");
+static_assert(std::numeric_limits<double>::is_iec559, "column files store IEEE 754 doubles");
+static_assert(sizeof(ColumnFileHeader) == 64);
+
+namespace
+{
+    constexpr char column_file_magic[8] = {'S', 'T', 'A', 'T', 'C', 'O', 'L', '\0'};
+    constexpr std::uint32_t column_file_version = 1;
+    constexpr size_t column_file_alignment = 64; // payload starts on a cache line
+
+    // ceil(value_count / chunk_size) that does not wrap for a huge chunk_size
+    std::uint64_t chunks_for(std::uint64_t value_count, std::uint64_t chunk_size)
+    {
+        return value_count == 0 ? 0 : (value_count - 1) / chunk_size + 1;
+    }
+
+    size_t align_up(size_t offset)
+    {
+        return (offset + column_file_alignment - 1) / column_file_alignment * column_file_alignment;
+    }
+
+    [[noreturn]] void invalid_column_file()
+    {
+        throw std::runtime_error("Invalid column file");
+    }
+} // namespace
+
+ColumnFile::ColumnFile(const std::string& file_name)
+    : file_{file_name}
+{
+    if (file_.size() < sizeof(ColumnFileHeader))
+        invalid_column_file();
+
+    std::memcpy(&header_, file_.data(), sizeof(header_));
+
+    if (std::memcmp(header_.magic, column_file_magic, sizeof(column_file_magic)) != 0 || header_.version != column_file_version)
+        invalid_column_file();
+
+    const std::uint64_t max_values = file_.size() / sizeof(double);
+    if (header_.chunk_size == 0 || header_.value_count > max_values
+        || header_.chunk_count != chunks_for(header_.value_count, header_.chunk_size))
+        invalid_column_file();
+
+    if (header_.payload_offset % alignof(double) != 0 || header_.payload_offset > file_.size()
+        || header_.value_count > (file_.size() - header_.payload_offset) / sizeof(double))
+        invalid_column_file();
+
+    values_ = {reinterpret_cast<const double*>(file_.data() + header_.payload_offset), header_.value_count};
+
+    if (has_chunk_summaries())
+    {
+        // the table lies between the header & the payload - compared by count, so nothing overflows
+        if (header_.summaries_offset % alignof(StatKernels::ChunkSummary) != 0
+            || header_.summaries_offset < sizeof(ColumnFileHeader)
+            || header_.summaries_offset > header_.payload_offset
+            || header_.chunk_count > (header_.payload_offset - header_.summaries_offset) / sizeof(StatKernels::ChunkSummary))
+            invalid_column_file();
+
+        chunk_summaries_ = {reinterpret_cast<const StatKernels::ChunkSummary*>(file_.data() + header_.summaries_offset), header_.chunk_count};
+    }
+}
+
+void ColumnFile::write(const std::string& file_name, std::span<const double> values, size_t chunk_size, bool with_chunk_summaries)
+{
+    if (chunk_size == 0)
+        throw std::invalid_argument("Chunk size must be positive");
+
+    ColumnFileHeader header{};
+    std::memcpy(header.magic, column_file_magic, sizeof(column_file_magic));
+    header.version = column_file_version;
+    header.flags = with_chunk_summaries ? has_chunk_summaries_flag : 0;
+    header.value_count = values.size();
+    header.chunk_size = chunk_size;
+    header.chunk_count = chunks_for(values.size(), chunk_size);
+    header.summaries_offset = sizeof(ColumnFileHeader);
+
+    std::vector<StatKernels::ChunkSummary> summaries;
+    if (with_chunk_summaries)
+    {
+        summaries.reserve(header.chunk_count);
+        for (size_t offset = 0; offset < values.size(); offset += chunk_size)
+            summaries.push_back(StatKernels::summarize(values.data() + offset, std::min(chunk_size, values.size() - offset)));
+    }
+
+    const size_t summaries_end = header.summaries_offset + summaries.size() * sizeof(StatKernels::ChunkSummary);
+    header.payload_offset = align_up(summaries_end);
+
+    std::ofstream fout(file_name.c_str(), std::ios::binary | std::ios::trunc);
+    if (!fout)
+        throw std::runtime_error("File not opened");
+
+    const char padding[column_file_alignment] = {};
+
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(summaries.data()), summaries.size() * sizeof(StatKernels::ChunkSummary));
+    fout.write(padding, header.payload_offset - summaries_end);
+    fout.write(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+
+    if (!fout.flush())
+        throw std::runtime_error("Column file not written");
+}
@@ -0,0 +1,82 @@
+#ifndef COLUMN_FILE_HPP
+#define COLUMN_FILE_HPP
+
+#include "data_loader.hpp"
+#include "stat_kernels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Header of the native binary column format. File layout (little-endian):
+//   ColumnFileHeader
+//   ChunkSummary[chunk_count] - only with has_chunk_summaries flag
+//   padding to payload_offset (multiple of column_file_alignment)
+//   double[value_count]
+struct ColumnFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t value_count;
+    std::uint64_t chunk_size;
+    std::uint64_t chunk_count;
+    std::uint64_t summaries_offset;
+    std::uint64_t payload_offset;
+    std::uint64_t reserved;
+};
+
+// Column of doubles used in place - the file is memory-mapped, nothing is parsed or copied
+class ColumnFile
+{
+    MappedFile file_;
+    ColumnFileHeader header_{};
+    std::span<const double> values_;
+    std::span<const StatKernels::ChunkSummary> chunk_summaries_;
+
+public:
+    static constexpr std::uint32_t has_chunk_summaries_flag = 1;
+    static constexpr size_t default_chunk_size = 64 * 1024;
+
+    // throws std::runtime_error when the file cannot be opened or is not a valid column file
+    explicit ColumnFile(const std::string& file_name);
+
+    static void write(const std::string& file_name, std::span<const double> values,
+        size_t chunk_size = default_chunk_size, bool with_chunk_summaries = true);
+
+    std::span<const double> values() const
+    {
+        return values_;
+    }
+
+    size_t chunk_size() const
+    {
+        return header_.chunk_size;
+    }
+
+    size_t chunk_count() const
+    {
+        return header_.chunk_count;
+    }
+
+    bool has_chunk_summaries() const
+    {
+        return header_.flags & has_chunk_summaries_flag;
+    }
+
+    // empty when the file was written without summaries
+    std::span<const StatKernels::ChunkSummary> chunk_summaries() const
+    {
+        return chunk_summaries_;
+    }
+
+    // index < chunk_count() - validated on open, so index * chunk_size() cannot overflow
+    std::span<const double> chunk(size_t index) const
+    {
+        return values_.subspan(index * chunk_size(), std::min(chunk_size(), values_.size() - index * chunk_size()));
+    }
+};
+
+#endif // COLUMN_FILE_HPP
@@ -0,0 +1,235 @@
+#ifndef DATA_ANALYZER_HPP
+#define DATA_ANALYZER_HPP
+
+#include "column_file.hpp"
+#include "data_loader.hpp"
+#include "execution_policy.hpp"
+#include "grouped_statistics.hpp"
+#include "statistics.hpp"
+#include "streaming_statistics.hpp"
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace Version_1
+{
+    class DataAnalyzer
+    {
+        std::shared_ptr<Statistics> strategy_;
+        std::shared_ptr<ExecutionPolicy> execution_;
+        Data loaded_data_;
+        std::optional<ColumnFile> column_file_;
+        DataView data_; // loaded_data_ or the values mapped from column_file_
+        AccumulatorPtr live_accumulator_; // state of the last calculate(), updated by append()
+        std::optional<size_t> live_results_offset_; // results of the last calculate() start there
+        Results results_;
+        std::vector<GroupResults> grouped_results_;
+
+        void clear()
+        {
+            data_ = {};
+            loaded_data_.clear();
+            column_file_.reset();
+            live_accumulator_.reset();
+            live_results_offset_.reset();
+            results_.clear();
+            grouped_results_.clear();
+        }
+
+    public:
+        explicit DataAnalyzer(std::shared_ptr<Statistics> strategy,
+            std::shared_ptr<ExecutionPolicy> execution = std::make_shared<SequentialExecution>())
+            : strategy_{std::move(strategy)}
+            , execution_{std::move(execution)}
+        {
+        }
+
+        void load_data(const std::string& file_name)
+        {
+            clear();
+
+            loaded_data_ = DataLoader::load_file(file_name, execution_->thread_pool());
+            data_ = loaded_data_;
+
+            std::cout << "File " << file_name << " has been loaded...\n";
+        }
+
+        // Binary column file - mapped and used in place, without parsing
+        void load_column_file(const std::string& file_name)
+        {
+            clear();
+
+            column_file_.emplace(file_name);
+            data_ = column_file_->values();
+
+            std::cout << "Column file " << file_name << " has been mapped (" << data_.size() << " values)...\n";
+        }
+
+        void save_column_file(const std::string& file_name) const
+        {
+            ColumnFile::write(file_name, data_);
+        }
+
+        // Streaming mode - values are consumed while the file is parsed and are not kept in memory
+        void stream_data(const std::string& file_name)
+        {
+            clear();
+
+            if (!strategy_)
+                return;
+
+            MappedFile file{file_name};
+
+            StreamingStatistics stream{*strategy_};
+            DataLoader::parse_values(file.content(), [&stream](double value) { stream.push(value); });
+            results_ = stream.results();
+
+            std::cout << "File " << file_name << " has been streamed (" << stream.count() << " values)...\n";
+        }
+
+        // Group-by mode - "key value" pairs, statistics computed per key in a single pass
+        void analyze_grouped(const std::string& file_name)
+        {
+            clear();
+
+            if (!strategy_)
+                return;
+
+            MappedFile file{file_name};
+
+            GroupedStatistics grouped{*strategy_};
+            grouped.add_text(file.content());
+            grouped_results_ = grouped.results();
+
+            std::cout << "File " << file_name << " has been analyzed (" << grouped.group_count() << " groups)...\n";
+        }
+
+        void set_statistics(std::shared_ptr<Statistics> strategy)
+        {
+            strategy_ = strategy;
+            live_accumulator_.reset();
+            live_results_offset_.reset();
+        }
+
+        void set_execution_policy(std::shared_ptr<ExecutionPolicy> execution)
+        {
+            execution_ = std::move(execution);
+        }
+
+        // Results are appended to the previous ones, as before. A fused group (or a single
+        // statistic) is computed with its accumulator, whose state is kept for append();
+        // a sequential group runs each statistic in its own pass.
+        void calculate()
+        {
+            live_accumulator_.reset();
+            live_results_offset_.reset();
+
+            if (!strategy_)
+                return;
+
+            live_results_offset_ = results_.size();
+
+            if (strategy_->execution_mode() == ExecutionMode::fused)
+            {
+                if (column_file_ && column_file_->has_chunk_summaries())
+                    live_accumulator_ = accumulate_chunks();
+                else
+                    live_accumulator_ = execution_->accumulate(*strategy_, data_);
+            }
+
+            if (live_accumulator_)
+                live_accumulator_->get_results(results_);
+            else
+                execution_->run(*strategy_, data_, results_);
+        }
+
+        // Adds values to the data and keeps the results of the last calculate() current by
+        // feeding only the new values to its accumulator state - floating-point results may
+        // differ in the last bits from a full recalculation. After a sequential calculate()
+        // the state is built from the data on the first append(). Statistics that cannot be
+        // accumulated are recalculated over all of the data. Results of earlier calculate()
+        // calls are left as they were. Data mapped from a column file is copied into memory
+        // first. values may be a view of the analyzer's own data.
+        void append(DataView values)
+        {
+            if (live_results_offset_ && !live_accumulator_)
+                live_accumulator_ = execution_->accumulate(*strategy_, data_);
+
+            // a view of the own data is addressed by index - reserve() & unmapping invalidate it
+            const bool aliased = !values.empty() && std::less_equal<>{}(data_.data(), values.data())
+                && std::less<>{}(values.data(), data_.data() + data_.size());
+            const size_t aliased_offset = aliased ? values.data() - data_.data() : 0;
+            const size_t old_size = data_.size();
+
+            loaded_data_.reserve(old_size + values.size());
+
+            if (column_file_)
+            {
+                loaded_data_.assign(data_.begin(), data_.end());
+                column_file_.reset();
+            }
+
+            if (aliased)
+            {
+                for (size_t i = 0; i < values.size(); ++i)
+                    loaded_data_.push_back(loaded_data_[aliased_offset + i]); // no reallocation - reserved above
+            }
+            else
+                loaded_data_.insert(loaded_data_.end(), values.begin(), values.end());
+
+            data_ = loaded_data_;
+            values = data_.subspan(old_size);
+
+            if (!live_results_offset_)
+                return;
+
+            results_.erase(results_.begin() + *live_results_offset_, results_.end());
+            if (live_accumulator_)
+            {
+                accumulate(*live_accumulator_, values);
+                live_accumulator_->get_results(results_);
+            }
+            else
+                execution_->run(*strategy_, data_, results_);
+        }
+
+        // values analyzed by calculate() - valid until the data is loaded or appended to
+        DataView data() const
+        {
+            return data_;
+        }
+
+        const Results& results() const
+        {
+            return results_;
+        }
+
+        const std::vector<GroupResults>& grouped_results() const
+        {
+            return grouped_results_;
+        }
+
+    private:
+        // statistics answered by chunk summaries never read the payload pages of the file
+        AccumulatorPtr accumulate_chunks() const
+        {
+            auto accumulator = strategy_->create_accumulator();
+            if (!accumulator)
+                return nullptr;
+
+            const auto summaries = column_file_->chunk_summaries();
+            for (size_t i = 0; i < summaries.size(); ++i)
+            {
+                const auto chunk = column_file_->chunk(i);
+                accumulator->update_chunk(summaries[i], chunk.data(), chunk.data() + chunk.size());
+            }
+
+            return accumulator;
+        }
+    };
+}
+
+#endif // DATA_ANALYZER_HPP
@@ -0,0 +1,215 @@
+#include "data_loader.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DATA_LOADER_MMAP
+#endif
+
+MappedFile::MappedFile(const std::string& file_name)
+{
+#ifdef DATA_LOADER_MMAP
+    const int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd == -1)
+        throw std::runtime_error("File not opened");
+
+    // only regular files can be mapped - pipes, FIFOs & /proc files report size 0
+    struct stat file_stat{};
+    if (::fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0)
+    {
+        void* address = ::mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED)
+        {
+            ::madvise(address, file_stat.st_size, MADV_SEQUENTIAL);
+            ::close(fd);
+            data_ = static_cast<const char*>(address);
+            size_ = file_stat.st_size;
+            mapped_ = true;
+            return;
+        }
+    }
+
+    // read from the descriptor already opened - reopening a FIFO would lose its data
+    char buffer[64 * 1024];
+    ssize_t count;
+    while ((count = ::read(fd, buffer, sizeof(buffer))) != 0)
+    {
+        if (count > 0)
+            fallback_buffer_.append(buffer, count);
+        else if (errno != EINTR)
+        {
+            ::close(fd);
+            throw std::runtime_error("File not read");
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream fin(file_name.c_str(), std::ios::binary);
+    if (!fin)
+        throw std::runtime_error("File not opened");
+
+    fallback_buffer_.assign(std::istreambuf_iterator<char>{fin}, std::istreambuf_iterator<char>{});
+#endif
+
+    data_ = fallback_buffer_.data();
+    size_ = fallback_buffer_.size();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}
+    , size_{std::exchange(other.size_, 0)}
+    , mapped_{std::exchange(other.mapped_, false)}
+    , fallback_buffer_{std::move(other.fallback_buffer_)}
+{
+    if (!mapped_)
+        data_ = fallback_buffer_.data();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        fallback_buffer_ = std::move(other.fallback_buffer_);
+        if (!mapped_)
+            data_ = fallback_buffer_.data();
+    }
+
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+void MappedFile::unmap()
+{
+#ifdef DATA_LOADER_MMAP
+    if (mapped_)
+        ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+}
+
+namespace DataLoader
+{
+    size_t count_tokens(std::string_view text)
+    {
+        size_t count = 0;
+        bool in_token = false;
+
+        for (const char c : text)
+        {
+            const bool space = is_space(c);
+            count += !space && !in_token;
+            in_token = !space;
+        }
+
+        return count;
+    }
+
+    namespace
+    {
+        struct ChunkResult
+        {
+            size_t parsed;
+            bool complete;
+        };
+
+        ChunkResult parse_into(std::string_view text, double* out)
+        {
+            size_t parsed = 0;
+            const bool complete = parse_values(text, [&](double value) { out[parsed++] = value; });
+            return {parsed, complete};
+        }
+
+        // chunk boundaries moved forward to the next whitespace, so no token is cut in half
+        std::vector<std::string_view> split_chunks(std::string_view text, size_t chunk_count)
+        {
+            std::vector<std::string_view> chunks;
+            chunks.reserve(chunk_count);
+
+            size_t start = 0;
+            for (size_t i = 1; i <= chunk_count && start < text.size(); ++i)
+            {
+                size_t end = i == chunk_count ? text.size() : std::max(start, text.size() * i / chunk_count);
+                while (end < text.size() && !is_space(text[end]))
+                    ++end;
+
+                chunks.push_back(text.substr(start, end - start));
+                start = end;
+            }
+
+            return chunks;
+        }
+    } // namespace
+
+    std::vector<double> parse(std::string_view text, ThreadPool* thread_pool)
+    {
+        constexpr size_t min_chunk_length = 1 << 20;
+
+        const size_t chunk_count = thread_pool ? std::min(thread_pool->size(), text.size() / min_chunk_length) : 1;
+
+        if (chunk_count <= 1)
+        {
+            std::vector<double> data(count_tokens(text));
+            auto [parsed, complete] = parse_into(text, data.data());
+            data.resize(parsed);
+            return data;
+        }
+
+        const auto chunks = split_chunks(text, chunk_count);
+
+        std::vector<std::future<size_t>> counts;
+        for (const auto& chunk : chunks)
+            counts.push_back(thread_pool->submit([chunk] { return count_tokens(chunk); }));
+
+        std::vector<size_t> offsets{0};
+        for (auto& count : counts)
+            offsets.push_back(offsets.back() + count.get());
+
+        std::vector<double> data(offsets.back());
+
+        std::vector<std::future<ChunkResult>> results;
+        for (size_t i = 0; i < chunks.size(); ++i)
+            results.push_back(thread_pool->submit([chunk = chunks[i], out = data.data() + offsets[i]] { return parse_into(chunk, out); }));
+
+        // values after the first invalid token are dropped - the same as a sequential parse
+        size_t size = data.size();
+        bool complete = true;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            auto result = results[i].get();
+            if (complete && !result.complete)
+            {
+                size = offsets[i] + result.parsed;
+                complete = false;
+            }
+        }
+
+        data.resize(size);
+        return data;
+    }
+
+    std::vector<double> load_file(const std::string& file_name, ThreadPool* thread_pool)
+    {
+        MappedFile file{file_name};
+        return parse(file.content(), thread_pool);
+    }
+}
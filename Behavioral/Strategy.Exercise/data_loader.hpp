@@ -0,0 +1,135 @@
+#ifndef DATA_LOADER_HPP
+#define DATA_LOADER_HPP
+
+#include "thread_pool.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only view of a whole file - memory-mapped where the platform allows it
+class MappedFile
+{
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::string fallback_buffer_; // used when the file cannot be mapped
+
+public:
+    explicit MappedFile(const std::string& file_name);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    const char* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    std::string_view content() const
+    {
+        return {data_, size_};
+    }
+
+private:
+    void unmap();
+};
+
+namespace DataLoader
+{
+    inline bool is_space(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+    }
+
+    // Calls consume(double) for every whitespace separated value in text.
+    // Like `while (in >> d)` it stops at the first token that is not a number - returns false then.
+    template <typename Consumer>
+    bool parse_values(std::string_view text, Consumer&& consume)
+    {
+        const char* pos = text.data();
+        const char* const end = pos + text.size();
+
+        while (true)
+        {
+            while (pos != end && is_space(*pos))
+                ++pos;
+
+            if (pos == end)
+                return true;
+
+            if (*pos == '+') // accepted by operator>>, not by from_chars
+                ++pos;
+
+            double value;
+            auto [ptr, ec] = std::from_chars(pos, end, value);
+            if (ec != std::errc{})
+                return false;
+
+            consume(value);
+
+            if (ptr != end && !is_space(*ptr)) // "3abc" - like operator>>, 3 is read, then parsing stops
+                return false;
+            pos = ptr;
+        }
+    }
+
+    // Calls consume(std::string_view key, double value) for every pair of whitespace separated
+    // tokens "key value". Stops at the first value that is not a number - returns false then,
+    // as well as for a key without a value.
+    template <typename Consumer>
+    bool parse_key_values(std::string_view text, Consumer&& consume)
+    {
+        const char* pos = text.data();
+        const char* const end = pos + text.size();
+
+        while (true)
+        {
+            while (pos != end && is_space(*pos))
+                ++pos;
+
+            if (pos == end)
+                return true;
+
+            const char* const key_begin = pos;
+            while (pos != end && !is_space(*pos))
+                ++pos;
+            const std::string_view key{key_begin, static_cast<size_t>(pos - key_begin)};
+
+            while (pos != end && is_space(*pos))
+                ++pos;
+
+            if (pos != end && *pos == '+')
+                ++pos;
+
+            double value;
+            auto [ptr, ec] = std::from_chars(pos, end, value);
+            if (ec != std::errc{} || (ptr != end && !is_space(*ptr)))
+                return false;
+
+            consume(key, value);
+            pos = ptr;
+        }
+    }
+
+    // number of whitespace separated tokens - used to pre-size the result
+    size_t count_tokens(std::string_view text);
+
+    // Parses all values from text. With a thread pool the text is split at whitespace
+    // into one chunk per thread and the chunks are parsed in place, in parallel.
+    std::vector<double> parse(std::string_view text, ThreadPool* thread_pool = nullptr);
+
+    std::vector<double> load_file(const std::string& file_name, ThreadPool* thread_pool = nullptr);
+}
+
+#endif // DATA_LOADER_HPP
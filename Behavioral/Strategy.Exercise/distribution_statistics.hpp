@@ -0,0 +1,291 @@
+#ifndef DISTRIBUTION_STATISTICS_HPP
+#define DISTRIBUTION_STATISTICS_HPP
+
+#include "kll_sketch.hpp"
+#include "statistics.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Statistics describing the distribution of values - memory use is fixed by their parameters,
+// not by the size of the data, and partial accumulators of parallel chunks merge
+namespace Version_1
+{
+    namespace Detail
+    {
+        inline std::string format_bucket(double lower, double upper)
+        {
+            std::ostringstream out;
+            out << "Hist[" << lower << ", " << upper << ")";
+            return out.str();
+        }
+    }
+
+    // Approximate quantiles from a KLL sketch - results are named P50, P99, P99.9 ...
+    class Quantiles : public Statistics
+    {
+        std::vector<double> quantiles_;
+        size_t k_;
+
+    public:
+        class Accumulator : public CloneableAccumulator<Accumulator>
+        {
+            std::vector<double> quantiles_;
+            KllSketch sketch_;
+
+        public:
+            Accumulator(std::vector<double> quantiles, size_t k)
+                : quantiles_{std::move(quantiles)}
+                , sketch_{k}
+            {
+            }
+
+            void update(const double* first, const double* last) override
+            {
+                sketch_.add(first, last);
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                sketch_.merge(static_cast<const Accumulator&>(other).sketch_);
+            }
+
+            void get_results(Results& results) const override
+            {
+                const auto values = sketch_.quantiles(quantiles_);
+                for (size_t i = 0; i < quantiles_.size(); ++i)
+                {
+                    std::ostringstream name;
+                    name << "P" << quantiles_[i] * 100;
+                    results.push_back(StatResult(name.str(), values[i]));
+                }
+            }
+        };
+
+        explicit Quantiles(std::initializer_list<double> quantiles = {0.5, 0.9, 0.99}, size_t k = KllSketch::default_k)
+            : quantiles_{quantiles}
+            , k_{k}
+        {
+            for (const double q : quantiles_)
+                if (!(q >= 0.0 && q <= 1.0))
+                    throw std::invalid_argument("Quantile must be in [0, 1]");
+        }
+
+        void calculate(DataView data, Results& results) const override
+        {
+            Accumulator accumulator{quantiles_, k_};
+            calculate_with(accumulator, data, results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>(quantiles_, k_);
+        }
+    };
+
+    // bucket_count equal-width buckets over [lower, upper), plus counts of values below and above.
+    // All buckets are reported, empty ones too; NaN values are not counted.
+    class Histogram : public Statistics
+    {
+        double lower_;
+        double upper_;
+        size_t bucket_count_;
+
+    public:
+        class Accumulator : public CloneableAccumulator<Accumulator>
+        {
+            double lower_;
+            double upper_;
+            double scale_;                     // buckets per unit
+            std::vector<std::uint64_t> counts_; // underflow, buckets..., overflow
+
+        public:
+            Accumulator(double lower, double upper, size_t bucket_count)
+                : lower_{lower}
+                , upper_{upper}
+                , scale_{bucket_count / (upper - lower)}
+                , counts_(bucket_count + 2)
+            {
+            }
+
+            void update(const double* first, const double* last) override
+            {
+                const size_t bucket_count = counts_.size() - 2;
+
+                for (; first != last; ++first)
+                {
+                    const double value = *first;
+                    if (std::isnan(value))
+                        continue;
+
+                    size_t index;
+                    if (value < lower_)
+                        index = 0;
+                    else if (value >= upper_)
+                        index = bucket_count + 1;
+                    else // rounding may put a value just below upper_ one bucket too far
+                        index = 1 + std::min(bucket_count - 1, static_cast<size_t>((value - lower_) * scale_));
+
+                    ++counts_[index];
+                }
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                const auto& other_hist = static_cast<const Accumulator&>(other);
+                for (size_t i = 0; i < counts_.size(); ++i)
+                    counts_[i] += other_hist.counts_[i];
+            }
+
+            void get_results(Results& results) const override
+            {
+                const size_t bucket_count = counts_.size() - 2;
+                const double width = (upper_ - lower_) / bucket_count;
+
+                results.push_back(StatResult(Detail::format_bucket(-std::numeric_limits<double>::infinity(), lower_), counts_.front()));
+                for (size_t i = 0; i < bucket_count; ++i)
+                {
+                    const double bucket_upper = i + 1 == bucket_count ? upper_ : lower_ + (i + 1) * width;
+                    results.push_back(StatResult(Detail::format_bucket(lower_ + i * width, bucket_upper), counts_[i + 1]));
+                }
+                results.push_back(StatResult(Detail::format_bucket(upper_, std::numeric_limits<double>::infinity()), counts_.back()));
+            }
+        };
+
+        Histogram(double lower, double upper, size_t bucket_count)
+            : lower_{lower}
+            , upper_{upper}
+            , bucket_count_{bucket_count}
+        {
+            if (!(std::isfinite(lower) && std::isfinite(upper) && lower < upper) || bucket_count == 0)
+                throw std::invalid_argument("Invalid histogram range");
+        }
+
+        void calculate(DataView data, Results& results) const override
+        {
+            Accumulator accumulator{lower_, upper_, bucket_count_};
+            calculate_with(accumulator, data, results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>(lower_, upper_, bucket_count_);
+        }
+    };
+
+    // HdrHistogram-like buckets for positive values such as latencies: every power of two
+    // between lowest and highest is split into sub_bucket_count (a power of two) linear buckets,
+    // so a bucket is never wider than 1 / sub_bucket_count of its lower bound.
+    // The range is widened to powers of two; values outside it are counted as underflow/overflow.
+    // Only non-empty buckets are reported.
+    class LogLinearHistogram : public Statistics
+    {
+        double lowest_;
+        double highest_;
+        unsigned sub_bucket_count_;
+
+    public:
+        class Accumulator : public CloneableAccumulator<Accumulator>
+        {
+            // for positive doubles exponent and top mantissa bits form an increasing key,
+            // so bucket index = (bits >> shift_) - first_key_
+            unsigned shift_;
+            std::uint64_t first_key_;
+            double lower_;
+            double upper_;
+            std::uint64_t underflow_{};
+            std::uint64_t overflow_{};
+            std::vector<std::uint64_t> counts_;
+
+            static constexpr std::uint64_t mantissa_mask = (std::uint64_t{1} << 52) - 1;
+
+            double bucket_bound(std::uint64_t key) const
+            {
+                return std::bit_cast<double>(key << shift_);
+            }
+
+        public:
+            Accumulator(double lowest, double highest, unsigned sub_bucket_count)
+                : shift_{52 - static_cast<unsigned>(std::countr_zero(sub_bucket_count))}
+            {
+                const std::uint64_t lower_bits = std::bit_cast<std::uint64_t>(lowest) & ~mantissa_mask;
+                const std::uint64_t upper_bits = (std::bit_cast<std::uint64_t>(highest) & ~mantissa_mask) + (mantissa_mask + 1);
+
+                first_key_ = lower_bits >> shift_;
+                lower_ = std::bit_cast<double>(lower_bits);
+                upper_ = std::bit_cast<double>(upper_bits);
+                counts_.resize((upper_bits >> shift_) - first_key_);
+            }
+
+            void update(const double* first, const double* last) override
+            {
+                for (; first != last; ++first)
+                {
+                    const double value = *first;
+                    if (value < lower_)
+                        ++underflow_;
+                    else if (value >= upper_)
+                        ++overflow_;
+                    else if (!std::isnan(value))
+                        ++counts_[(std::bit_cast<std::uint64_t>(value) >> shift_) - first_key_];
+                }
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                const auto& other_hist = static_cast<const Accumulator&>(other);
+                for (size_t i = 0; i < counts_.size(); ++i)
+                    counts_[i] += other_hist.counts_[i];
+                underflow_ += other_hist.underflow_;
+                overflow_ += other_hist.overflow_;
+            }
+
+            void get_results(Results& results) const override
+            {
+                if (underflow_)
+                    results.push_back(StatResult(Detail::format_bucket(-std::numeric_limits<double>::infinity(), lower_), underflow_));
+
+                for (size_t i = 0; i < counts_.size(); ++i)
+                {
+                    if (counts_[i])
+                        results.push_back(StatResult(Detail::format_bucket(bucket_bound(first_key_ + i), bucket_bound(first_key_ + i + 1)), counts_[i]));
+                }
+
+                if (overflow_)
+                    results.push_back(StatResult(Detail::format_bucket(upper_, std::numeric_limits<double>::infinity()), overflow_));
+            }
+        };
+
+        LogLinearHistogram(double lowest, double highest, unsigned sub_bucket_count = 16)
+            : lowest_{lowest}
+            , highest_{highest}
+            , sub_bucket_count_{sub_bucket_count}
+        {
+            if (!(lowest >= std::numeric_limits<double>::min() && lowest < highest && highest < std::numeric_limits<double>::max() / 2))
+                throw std::invalid_argument("Invalid histogram range");
+
+            if (!std::has_single_bit(sub_bucket_count) || sub_bucket_count > (1u << 20))
+                throw std::invalid_argument("Sub-bucket count must be a power of two");
+        }
+
+        void calculate(DataView data, Results& results) const override
+        {
+            Accumulator accumulator{lowest_, highest_, sub_bucket_count_};
+            calculate_with(accumulator, data, results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>(lowest_, highest_, sub_bucket_count_);
+        }
+    };
+}
+
+#endif // DISTRIBUTION_STATISTICS_HPP
@@ -0,0 +1,163 @@
+#ifndef EXECUTION_POLICY_HPP
+#define EXECUTION_POLICY_HPP
+
+#include "statistics.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <exception>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace Version_1
+{
+    // How DataAnalyzer runs its statistics over the data
+    class ExecutionPolicy
+    {
+    public:
+        virtual ~ExecutionPolicy() = default;
+        virtual void run(const Statistics& statistics, DataView data, Results& results) const = 0;
+
+        // accumulator state of statistics over data - nullptr when statistics cannot be accumulated
+        virtual AccumulatorPtr accumulate(const Statistics& statistics, DataView data) const
+        {
+            auto accumulator = statistics.create_accumulator();
+            if (accumulator)
+                Version_1::accumulate(*accumulator, data);
+            return accumulator;
+        }
+
+        // pool that may also be used for parsing input - nullptr for single-threaded policies
+        virtual ThreadPool* thread_pool() const
+        {
+            return nullptr;
+        }
+    };
+
+    class SequentialExecution : public ExecutionPolicy
+    {
+    public:
+        void run(const Statistics& statistics, DataView data, Results& results) const override
+        {
+            statistics.calculate(data, results);
+        }
+    };
+
+    // Splits data into fixed-size chunks accumulated on a thread pool. Partial accumulators
+    // are merged pairwise in chunk order, so the result depends only on chunk_size -
+    // it is bit-identical from run to run, whatever the number of threads.
+    // Statistics without an accumulator run sequentially on the calling thread.
+    // run() blocks until the chunks are done - do not call it from a task of the same pool.
+    class ParallelExecution : public ExecutionPolicy
+    {
+        std::shared_ptr<ThreadPool> thread_pool_;
+        size_t chunk_size_;
+
+    public:
+        static constexpr size_t default_chunk_size = 16 * fused_block_size;
+
+        explicit ParallelExecution(std::shared_ptr<ThreadPool> thread_pool, size_t chunk_size = default_chunk_size)
+            : thread_pool_{std::move(thread_pool)}
+            , chunk_size_{std::max<size_t>(chunk_size, 1)}
+        {
+        }
+
+        void run(const Statistics& statistics, DataView data, Results& results) const override
+        {
+            if (data.size() > chunk_size_)
+            {
+                if (auto accumulator = accumulate(statistics, data))
+                {
+                    accumulator->get_results(results);
+                    return;
+                }
+            }
+
+            statistics.calculate(data, results);
+        }
+
+        AccumulatorPtr accumulate(const Statistics& statistics, DataView data) const override
+        {
+            if (data.size() <= chunk_size_)
+                return ExecutionPolicy::accumulate(statistics, data);
+
+            auto accumulator = statistics.create_accumulator();
+            if (!accumulator)
+                return nullptr;
+
+            const size_t chunk_count = (data.size() + chunk_size_ - 1) / chunk_size_;
+
+            std::vector<AccumulatorPtr> partials;
+            partials.reserve(chunk_count);
+            partials.push_back(std::move(accumulator));
+            while (partials.size() < chunk_count)
+                partials.push_back(statistics.create_accumulator());
+
+            std::atomic<size_t> next_chunk{0};
+            auto worker = [&] {
+                try
+                {
+                    for (size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+                    {
+                        const double* first = data.data() + chunk * chunk_size_;
+                        const double* last = first + std::min(chunk_size_, data.size() - chunk * chunk_size_);
+                        Version_1::accumulate(*partials[chunk], first, last);
+                    }
+                }
+                catch (...)
+                {
+                    next_chunk = chunk_count; // the other workers stop after their current chunk
+                    throw;
+                }
+            };
+
+            const size_t worker_count = std::min(thread_pool_->size(), chunk_count);
+            std::vector<std::future<void>> workers;
+            std::exception_ptr error;
+
+            try
+            {
+                workers.reserve(worker_count);
+                for (size_t i = 0; i < worker_count; ++i)
+                    workers.push_back(thread_pool_->submit(worker));
+            }
+            catch (...)
+            {
+                next_chunk = chunk_count;
+                error = std::current_exception();
+            }
+
+            // the workers refer to this frame - every one is waited for before an error is rethrown
+            for (auto& w : workers)
+            {
+                try
+                {
+                    w.get();
+                }
+                catch (...)
+                {
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+
+            if (error)
+                std::rethrow_exception(error);
+
+            // deterministic reduction tree: ((p0 + p1) + (p2 + p3)) + ...
+            for (size_t step = 1; step < chunk_count; step *= 2)
+                for (size_t i = 0; i + step < chunk_count; i += 2 * step)
+                    partials[i]->merge(*partials[i + step]);
+
+            return std::move(partials.front());
+        }
+
+        ThreadPool* thread_pool() const override
+        {
+            return thread_pool_.get();
+        }
+    };
+}
+
+#endif // EXECUTION_POLICY_HPP
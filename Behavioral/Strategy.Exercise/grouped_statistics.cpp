@@ -0,0 +1,208 @@
+#include "grouped_statistics.hpp"
+#include "data_loader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace Version_1
+{
+    namespace
+    {
+        constexpr size_t initial_slot_count = 16;
+
+        // room for one more element, so that the next push_back cannot throw
+        template <typename T>
+        void reserve_next(std::vector<T>& v)
+        {
+            if (v.size() == v.capacity())
+                v.reserve(std::max<size_t>(2 * v.capacity(), initial_slot_count));
+        }
+    }
+
+    GroupIndex::GroupIndex()
+        : slots_(initial_slot_count, Slot{0, empty_slot, 0, {}})
+        , key_offsets_{0}
+    {
+    }
+
+    size_t GroupIndex::find(std::string_view key, std::uint64_t hash) const
+    {
+        const size_t mask = slots_.size() - 1;
+
+        for (size_t i = hash & mask;; i = (i + 1) & mask)
+        {
+            const Slot& slot = slots_[i];
+
+            if (slot.group == empty_slot)
+                return npos;
+
+            if (matches(slot, key, hash))
+                return slot.group;
+        }
+    }
+
+    size_t GroupIndex::insert(std::string_view key, std::uint64_t hash)
+    {
+        if (size() == empty_slot)
+            throw std::length_error("Too many groups");
+
+        if (key.size() > empty_slot)
+            throw std::length_error("Key too long");
+
+        // everything that may throw comes before the slot is taken
+        if (2 * (size() + 1) > slots_.size()) // load factor kept at most 1/2
+            grow();
+        reserve_next(key_offsets_);
+        key_arena_.append(key);
+
+        const size_t group = size();
+        key_offsets_.push_back(key_arena_.size());
+
+        const size_t mask = slots_.size() - 1;
+        size_t i = hash & mask;
+        while (slots_[i].group != empty_slot)
+            i = (i + 1) & mask;
+
+        Slot& slot = slots_[i];
+        slot = Slot{hash, static_cast<std::uint32_t>(group), static_cast<std::uint32_t>(key.size()), {}};
+        std::memcpy(slot.key_prefix, key.data(), std::min(key.size(), inline_key_size));
+
+        return group;
+    }
+
+    bool GroupIndex::matches(const Slot& slot, std::string_view key, std::uint64_t hash) const
+    {
+        if (slot.hash != hash || slot.key_size != key.size())
+            return false;
+
+        if (key.size() <= inline_key_size)
+            return std::memcmp(slot.key_prefix, key.data(), key.size()) == 0;
+
+        return this->key(slot.group) == key;
+    }
+
+    void GroupIndex::grow()
+    {
+        std::vector<Slot> slots(2 * slots_.size(), Slot{0, empty_slot, 0, {}});
+        const size_t mask = slots.size() - 1;
+
+        for (const Slot& slot : slots_)
+        {
+            if (slot.group == empty_slot)
+                continue;
+
+            size_t i = slot.hash & mask;
+            while (slots[i].group != empty_slot)
+                i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+
+        slots_.swap(slots);
+    }
+
+    GroupedStatistics::GroupedStatistics(const Statistics& statistics)
+        : statistics_{statistics}
+        , prototype_{statistics_.create_accumulator()}
+    {
+        if (!prototype_)
+            throw std::invalid_argument("Statistics cannot be computed per group");
+
+        slot_size_ = aligned_clone_size(prototype_->clone_size());
+    }
+
+    GroupedStatistics::~GroupedStatistics()
+    {
+        if (slot_size_ != 0)
+        {
+            for (size_t group = 0; group < batch_sizes_.size(); ++group)
+                std::destroy_at(&accumulator(group));
+        }
+    }
+
+    size_t GroupedStatistics::insert_group(std::string_view key, std::uint64_t hash)
+    {
+        add_group();
+
+        try
+        {
+            return groups_.insert(key, hash);
+        }
+        catch (...)
+        {
+            remove_last_group();
+            throw;
+        }
+    }
+
+    // all or nothing - the vectors get their room before the accumulator is created
+    void GroupedStatistics::add_group()
+    {
+        const size_t group = batch_sizes_.size();
+
+        reserve_next(batches_);
+        reserve_next(batch_sizes_);
+
+        if (slot_size_ == 0)
+        {
+            reserve_next(allocated_accumulators_);
+            allocated_accumulators_.push_back(statistics_.create_accumulator());
+        }
+        else
+        {
+            std::unique_ptr<std::byte[]> block;
+            if (group % groups_per_block == 0)
+            {
+                reserve_next(blocks_);
+                block.reset(new std::byte[groups_per_block * slot_size_]);
+            }
+
+            std::byte* slot = (block ? block.get() : blocks_.back().get()) + group % groups_per_block * slot_size_;
+            base_offset_ = reinterpret_cast<std::byte*>(prototype_->clone_into(slot)) - slot;
+
+            if (block)
+                blocks_.push_back(std::move(block));
+        }
+
+        batches_.emplace_back();
+        batch_sizes_.push_back(0);
+    }
+
+    void GroupedStatistics::remove_last_group() noexcept
+    {
+        const size_t group = batch_sizes_.size() - 1;
+
+        if (slot_size_ == 0)
+            allocated_accumulators_.pop_back();
+        else
+        {
+            std::destroy_at(&accumulator(group));
+            if (group % groups_per_block == 0)
+                blocks_.pop_back();
+        }
+
+        batches_.pop_back();
+        batch_sizes_.pop_back();
+    }
+
+    bool GroupedStatistics::add_text(std::string_view text)
+    {
+        return DataLoader::parse_key_values(text, [this](std::string_view key, double value) { add(key, value); });
+    }
+
+    std::vector<GroupResults> GroupedStatistics::results()
+    {
+        std::vector<GroupResults> results;
+        results.reserve(group_count());
+
+        for (size_t group = 0; group < group_count(); ++group)
+        {
+            flush(group);
+            results.push_back(GroupResults{std::string{groups_.key(group)}, {}});
+            accumulator(group).get_results(results.back().results);
+        }
+
+        return results;
+    }
+}
@@ -0,0 +1,159 @@
+#ifndef GROUPED_STATISTICS_HPP
+#define GROUPED_STATISTICS_HPP
+
+#include "statistics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Version_1
+{
+    // Maps keys to dense group numbers 0, 1, 2 ... in order of first appearance.
+    // Flat open-addressing table with linear probing: a 32-byte slot holds the full hash,
+    // the group number and the first bytes of the key, so a lookup of a short key touches
+    // a single cache line. Whole keys live back to back in one arena. The hash of a key is
+    // computed once - growing the table reuses the stored hashes.
+    class GroupIndex
+    {
+        static constexpr size_t inline_key_size = 16;
+
+        struct alignas(32) Slot
+        {
+            std::uint64_t hash;
+            std::uint32_t group;
+            std::uint32_t key_size;
+            char key_prefix[inline_key_size];
+        };
+
+        static constexpr std::uint32_t empty_slot = std::numeric_limits<std::uint32_t>::max();
+
+        std::vector<Slot> slots_;
+        std::string key_arena_;
+        std::vector<size_t> key_offsets_; // group -> start of its key in key_arena_, plus end sentinel
+
+    public:
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        GroupIndex();
+
+        // group of key - npos when the key has not been inserted
+        size_t find(std::string_view key, std::uint64_t hash) const;
+
+        // the next group for a key that is not in the index yet - on an exception
+        // the index is left as it was
+        size_t insert(std::string_view key, std::uint64_t hash);
+
+        size_t size() const
+        {
+            return key_offsets_.size() - 1;
+        }
+
+        std::string_view key(size_t group) const
+        {
+            return std::string_view{key_arena_}.substr(key_offsets_[group], key_offsets_[group + 1] - key_offsets_[group]);
+        }
+
+    private:
+        bool matches(const Slot& slot, std::string_view key, std::uint64_t hash) const;
+        void grow();
+    };
+
+    struct GroupResults
+    {
+        std::string key;
+        Results results;
+    };
+
+    // Statistics computed separately for every key in a single pass over "key value" pairs.
+    // Every group gets its own copy of one accumulator of the statistics. The copies are
+    // cloned in place into a flat table - blocks of groups_per_block equal-sized slots - so
+    // the state of a group is found by its number, without a pointer per group, and a group
+    // costs no allocations of its own. Accumulators that cannot be cloned in place are
+    // allocated one by one instead. Values are staged in a cache line per group and reach
+    // the accumulator in batches, so with millions of groups each value costs a few cache
+    // misses and one virtual call per batch. A key enters the index only once its group
+    // has been set up, so an exception leaves the groups as they were.
+    class GroupedStatistics
+    {
+        static constexpr size_t batch_size = 8;
+        static constexpr size_t groups_per_block = 1024;
+
+        struct alignas(64) Batch
+        {
+            double values[batch_size];
+        };
+
+        const Statistics& statistics_;
+        GroupIndex groups_;
+        AccumulatorPtr prototype_;                          // empty state copied for new groups
+        size_t slot_size_{};                                // 0 - accumulators allocated one by one
+        size_t base_offset_{};                              // of Accumulator within a slot
+        std::vector<std::unique_ptr<std::byte[]>> blocks_;  // slots of the groups
+        std::vector<AccumulatorPtr> allocated_accumulators_; // indexed by group, when slot_size_ is 0
+        std::vector<Batch> batches_;                         // staged values, one cache line per group
+        std::vector<std::uint8_t> batch_sizes_;
+
+    public:
+        // throws std::invalid_argument when statistics cannot be accumulated
+        explicit GroupedStatistics(const Statistics& statistics);
+
+        GroupedStatistics(const GroupedStatistics&) = delete;
+        GroupedStatistics& operator=(const GroupedStatistics&) = delete;
+        ~GroupedStatistics();
+
+        void add(std::string_view key, double value)
+        {
+            const std::uint64_t hash = std::hash<std::string_view>{}(key);
+
+            size_t group = groups_.find(key, hash);
+            if (group == GroupIndex::npos)
+                group = insert_group(key, hash);
+
+            batches_[group].values[batch_sizes_[group]++] = value;
+
+            if (batch_sizes_[group] == batch_size)
+                flush(group);
+        }
+
+        // whitespace separated "key value" pairs - stops at the first invalid one, returns false then
+        bool add_text(std::string_view text);
+
+        size_t group_count() const
+        {
+            return groups_.size();
+        }
+
+        // in order of first appearance of the keys
+        std::vector<GroupResults> results();
+
+    private:
+        size_t insert_group(std::string_view key, std::uint64_t hash);
+        void add_group();
+        void remove_last_group() noexcept;
+
+        Accumulator& accumulator(size_t group)
+        {
+            if (slot_size_ == 0)
+                return *allocated_accumulators_[group];
+
+            std::byte* slot = blocks_[group / groups_per_block].get() + group % groups_per_block * slot_size_;
+            return *std::launder(reinterpret_cast<Accumulator*>(slot + base_offset_));
+        }
+
+        void flush(size_t group)
+        {
+            const double* batch = batches_[group].values;
+            accumulator(group).update(batch, batch + batch_sizes_[group]);
+            batch_sizes_[group] = 0;
+        }
+    };
+}
+
+#endif // GROUPED_STATISTICS_HPP
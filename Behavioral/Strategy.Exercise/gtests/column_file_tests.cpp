@@ -0,0 +1,217 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "column_file.hpp"
+
+using namespace ::testing;
+
+struct ColumnFileTests : ::testing::Test
+{
+    std::filesystem::path directory;
+    std::string path;
+    std::vector<double> values;
+
+    ColumnFileTests()
+    {
+        directory = std::filesystem::temp_directory_path() / ("column_file_tests_" + std::to_string(::getpid()) + "_"
+                        + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        path = (directory / "values.col").string();
+
+        for (int i = 0; i < 1000; ++i)
+            values.push_back(i % 7 - 3.5);
+    }
+
+    ~ColumnFileTests() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    ColumnFileHeader read_header()
+    {
+        ColumnFileHeader header{};
+        std::ifstream fin{path, std::ios::binary};
+        fin.read(reinterpret_cast<char*>(&header), sizeof(header));
+        return header;
+    }
+
+    void write_header(const ColumnFileHeader& header)
+    {
+        std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+};
+
+TEST_F(ColumnFileTests, ValuesAreReadBack)
+{
+    ColumnFile::write(path, values, 64);
+
+    ColumnFile file{path};
+
+    ASSERT_THAT(std::vector<double>(file.values().begin(), file.values().end()), ContainerEq(values));
+    ASSERT_EQ(file.chunk_size(), 64u);
+    ASSERT_EQ(file.chunk_count(), 16u); // 15 full chunks & 40 values
+    ASSERT_EQ(file.chunk(15).size(), 40u);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(file.values().data()) % 64, 0u);
+}
+
+TEST_F(ColumnFileTests, ChunkSummariesMatchChunks)
+{
+    ColumnFile::write(path, values, 64);
+
+    ColumnFile file{path};
+
+    ASSERT_TRUE(file.has_chunk_summaries());
+    ASSERT_EQ(file.chunk_summaries().size(), file.chunk_count());
+    for (size_t i = 0; i < file.chunk_count(); ++i)
+    {
+        const auto chunk = file.chunk(i);
+        const auto expected = StatKernels::summarize(chunk.data(), chunk.size());
+        ASSERT_EQ(file.chunk_summaries()[i].min, expected.min);
+        ASSERT_EQ(file.chunk_summaries()[i].max, expected.max);
+        ASSERT_EQ(file.chunk_summaries()[i].sum, expected.sum);
+    }
+}
+
+TEST_F(ColumnFileTests, FileWithoutSummariesHasNone)
+{
+    ColumnFile::write(path, values, 64, false);
+
+    ColumnFile file{path};
+
+    ASSERT_FALSE(file.has_chunk_summaries());
+    ASSERT_TRUE(file.chunk_summaries().empty());
+    ASSERT_EQ(file.values().size(), values.size());
+}
+
+TEST_F(ColumnFileTests, EmptyColumnHasNoChunks)
+{
+    ColumnFile::write(path, {}, 64);
+
+    ColumnFile file{path};
+
+    ASSERT_TRUE(file.values().empty());
+    ASSERT_EQ(file.chunk_count(), 0u);
+}
+
+TEST_F(ColumnFileTests, ZeroChunkSizeIsNotWritten)
+{
+    ASSERT_THROW(ColumnFile::write(path, values, 0), std::invalid_argument);
+}
+
+TEST_F(ColumnFileTests, MissingFileIsRejected)
+{
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
+
+TEST_F(ColumnFileTests, TextFileIsRejected)
+{
+    std::ofstream{path} << "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30\n";
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
+
+TEST_F(ColumnFileTests, TruncatedPayloadIsRejected)
+{
+    ColumnFile::write(path, values, 64);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - sizeof(double));
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
+
+struct ColumnFileHeaderTests : ColumnFileTests
+{
+    ColumnFileHeader header;
+
+    void SetUp() override
+    {
+        ColumnFile::write(path, values, 64);
+        header = read_header();
+    }
+};
+
+TEST_F(ColumnFileHeaderTests, WrongVersionIsRejected)
+{
+    ++header.version;
+    write_header(header);
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
+
+TEST_F(ColumnFileHeaderTests, ZeroChunkSizeIsRejected)
+{
+    header.chunk_size = 0;
+    write_header(header);
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
+
+TEST_F(ColumnFileHeaderTests, ChunkCountNotMatchingValuesIsRejected)
+{
+    ++header.chunk_count;
+    write_header(header);
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
+
+TEST_F(ColumnFileHeaderTests, ChunkCountOfHugeChunkSizeDoesNotWrap)
+{
+    // ceil(1000 / chunk_size) computed as (1000 + chunk_size - 1) / chunk_size would wrap to 0
+    header.chunk_size = std::numeric_limits<std::uint64_t>::max();
+    header.chunk_count = 0;
+    header.flags = 0;
+    write_header(header);
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+
+    header.chunk_count = 1;
+    write_header(header);
+
+    ColumnFile file{path};
+    ASSERT_EQ(file.chunk(0).size(), values.size());
+}
+
+TEST_F(ColumnFileHeaderTests, ValueCountBeyondFileIsRejected)
+{
+    header.value_count += 1;
+    header.flags = 0;
+    header.chunk_count = (header.value_count + 63) / 64;
+    write_header(header);
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
+
+TEST_F(ColumnFileHeaderTests, PayloadOffsetBeyondFileIsRejected)
+{
+    header.payload_offset = std::numeric_limits<std::uint64_t>::max() - 7;
+    write_header(header);
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
+
+TEST_F(ColumnFileHeaderTests, SummariesOverlappingHeaderAreRejected)
+{
+    header.summaries_offset = 0;
+    write_header(header);
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
+
+TEST_F(ColumnFileHeaderTests, SummariesOverlappingPayloadAreRejected)
+{
+    header.summaries_offset = header.payload_offset - sizeof(StatKernels::ChunkSummary);
+    write_header(header);
+
+    ASSERT_THROW(ColumnFile{path}, std::runtime_error);
+}
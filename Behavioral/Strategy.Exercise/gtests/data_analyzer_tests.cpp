@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "data_analyzer.hpp"
+#include "distribution_statistics.hpp"
+
+using namespace ::testing;
+using namespace Version_1;
+
+namespace
+{
+    // computed from all of the data at once - has no accumulator
+    class Median : public Statistics
+    {
+    public:
+        void calculate(DataView data, Results& results) const override
+        {
+            Data sorted(data.begin(), data.end());
+            std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+            results.push_back(StatResult("Median", sorted[sorted.size() / 2]));
+        }
+    };
+
+    std::vector<double> values_of(const Results& results)
+    {
+        std::vector<double> values;
+        for (const auto& result : results)
+            values.push_back(result.value);
+        return values;
+    }
+
+    std::shared_ptr<Statistics> group(std::initializer_list<std::shared_ptr<Statistics>> statistics, ExecutionMode mode)
+    {
+        return std::make_shared<StatGroup>(statistics, mode);
+    }
+} // namespace
+
+TEST(DataAnalyzer_Append, KeepsAccumulatedResultsCurrent)
+{
+    DataAnalyzer da{group({std::make_shared<MinMax>(), std::make_shared<Sum>()}, ExecutionMode::fused)};
+    da.append(Data{1.0, 2.0, 3.0});
+    da.calculate();
+
+    da.append(Data{10.0, -4.0});
+
+    ASSERT_THAT(values_of(da.results()), ElementsAre(-4.0, 10.0, 12.0));
+}
+
+TEST(DataAnalyzer_Append, RecalculatesStatisticsWithoutAccumulator)
+{
+    DataAnalyzer da{std::make_shared<Median>()};
+    da.append(Data{1.0, 2.0, 3.0});
+    da.calculate();
+    ASSERT_THAT(values_of(da.results()), ElementsAre(2.0));
+
+    da.append(Data{10.0, 11.0});
+
+    ASSERT_THAT(values_of(da.results()), ElementsAre(3.0));
+}
+
+TEST(DataAnalyzer_Append, RecalculatesGroupWithStatisticWithoutAccumulator)
+{
+    DataAnalyzer da{group({std::make_shared<Sum>(), std::make_shared<Median>()}, ExecutionMode::fused)};
+    da.append(Data{1.0, 2.0, 3.0});
+    da.calculate();
+
+    da.append(Data{10.0, 11.0});
+
+    ASSERT_THAT(values_of(da.results()), ElementsAre(27.0, 3.0));
+}
+
+TEST(DataAnalyzer_Append, UpdatesSequentialGroup)
+{
+    DataAnalyzer da{group({std::make_shared<Average>(), std::make_shared<Sum>()}, ExecutionMode::sequential)};
+    da.append(Data{1.0, 2.0, 3.0});
+    da.calculate();
+
+    da.append(Data{6.0});
+
+    ASSERT_THAT(values_of(da.results()), ElementsAre(3.0, 12.0));
+}
+
+TEST(DataAnalyzer_Append, KeepsResultsOfEarlierCalculations)
+{
+    DataAnalyzer da{std::make_shared<Sum>()};
+    da.append(Data{1.0, 2.0});
+    da.calculate();
+    da.calculate();
+
+    da.append(Data{3.0});
+
+    ASSERT_THAT(values_of(da.results()), ElementsAre(3.0, 6.0));
+}
+
+TEST(DataAnalyzer_Append, AppendsViewOfOwnData)
+{
+    DataAnalyzer da{std::make_shared<Sum>()};
+    da.append(Data{1.0, 2.0, 3.0});
+    da.calculate();
+
+    for (int i = 0; i < 4; ++i)
+        da.append(da.data()); // the data doubles - and reallocates
+
+    ASSERT_EQ(da.data().size(), 48u);
+    ASSERT_THAT(std::vector<double>(da.data().begin(), da.data().begin() + 6), ElementsAre(1.0, 2.0, 3.0, 1.0, 2.0, 3.0));
+    ASSERT_THAT(values_of(da.results()), ElementsAre(96.0));
+}
+
+TEST(DataAnalyzer_Append, AppendsPartOfOwnData)
+{
+    DataAnalyzer da{std::make_shared<Sum>()};
+    da.append(Data{1.0, 2.0, 3.0});
+    da.calculate();
+
+    da.append(da.data().subspan(1));
+
+    ASSERT_THAT(std::vector<double>(da.data().begin(), da.data().end()), ElementsAre(1.0, 2.0, 3.0, 2.0, 3.0));
+    ASSERT_THAT(values_of(da.results()), ElementsAre(11.0));
+}
+
+TEST(DataAnalyzer_Append, AppendsViewOfMappedColumnFile)
+{
+    const auto path = std::filesystem::temp_directory_path() / ("data_analyzer_tests_" + std::to_string(::getpid()) + ".col");
+    ColumnFile::write(path.string(), Data{1.0, 2.0, 3.0});
+
+    DataAnalyzer da{std::make_shared<Sum>()};
+    da.load_column_file(path.string());
+    da.calculate();
+
+    da.append(da.data()); // the mapping is released while the values are copied
+
+    std::filesystem::remove(path);
+    ASSERT_THAT(std::vector<double>(da.data().begin(), da.data().end()), ElementsAre(1.0, 2.0, 3.0, 1.0, 2.0, 3.0));
+    ASSERT_THAT(values_of(da.results()), ElementsAre(12.0));
+}
@@ -0,0 +1,172 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "execution_policy.hpp"
+#include "statistics.hpp"
+
+using namespace ::testing;
+using namespace Version_1;
+
+namespace
+{
+    Data random_values(size_t size)
+    {
+        std::mt19937_64 rnd{2024};
+        std::uniform_real_distribution<double> mantissa{-1.0, 1.0};
+        std::uniform_int_distribution<int> exponent{-20, 20};
+
+        Data values(size);
+        for (auto& value : values)
+            value = std::ldexp(mantissa(rnd), exponent(rnd));
+        return values;
+    }
+
+    std::shared_ptr<Statistics> all_statistics()
+    {
+        std::shared_ptr<Statistics> avg = std::make_shared<Average>();
+        std::shared_ptr<Statistics> min_max = std::make_shared<MinMax>();
+        std::shared_ptr<Statistics> sum = std::make_shared<Sum>();
+        std::shared_ptr<Statistics> variance = std::make_shared<Variance>();
+        return std::make_shared<StatGroup>(std::initializer_list<std::shared_ptr<Statistics>>{avg, min_max, sum, variance}, ExecutionMode::fused);
+    }
+
+    Results run_parallel(const Statistics& statistics, DataView data, size_t thread_count, size_t chunk_size)
+    {
+        ParallelExecution execution{std::make_shared<ThreadPool>(thread_count), chunk_size};
+        Results results;
+        execution.run(statistics, data, results);
+        return results;
+    }
+
+    bool bit_equal(double a, double b)
+    {
+        return std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+
+    // throws for the chunk starting with -1.0 - the other chunks take a while
+    class FailingChunk : public Statistics
+    {
+    public:
+        static inline std::atomic<int> running{0};
+
+        class Accumulator : public Version_1::Accumulator
+        {
+        public:
+            void update(const double* first, const double* last) override
+            {
+                ++running;
+                const bool failing = *first == -1.0;
+                if (!failing)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                --running;
+
+                if (failing)
+                    throw std::runtime_error("chunk failed");
+            }
+
+            void merge(const Version_1::Accumulator&) override
+            {
+            }
+
+            void get_results(Results&) const override
+            {
+            }
+        };
+
+        void calculate(DataView, Results&) const override
+        {
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>();
+        }
+    };
+} // namespace
+
+TEST(ParallelExecution, ResultsAreBitIdenticalForEveryThreadCount)
+{
+    const auto data = random_values(100'003);
+    const auto statistics = all_statistics();
+
+    const Results expected = run_parallel(*statistics, data, 1, 1000);
+    ASSERT_EQ(expected.size(), 6u);
+
+    for (size_t thread_count : {2u, 3u, 4u, 7u, 8u, 16u})
+    {
+        const Results results = run_parallel(*statistics, data, thread_count, 1000);
+
+        ASSERT_EQ(results.size(), expected.size());
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            ASSERT_EQ(results[i].description, expected[i].description);
+            ASSERT_TRUE(bit_equal(results[i].value, expected[i].value))
+                << thread_count << " threads, " << results[i].description << ": " << results[i].value << " != " << expected[i].value;
+        }
+    }
+}
+
+TEST(ParallelExecution, ResultsAreRepeatable)
+{
+    const auto data = random_values(50'000);
+    const auto statistics = all_statistics();
+
+    const Results first = run_parallel(*statistics, data, 4, 512);
+    for (int run = 0; run < 10; ++run)
+    {
+        const Results results = run_parallel(*statistics, data, 4, 512);
+        for (size_t i = 0; i < results.size(); ++i)
+            ASSERT_TRUE(bit_equal(results[i].value, first[i].value)) << results[i].description;
+    }
+}
+
+TEST(ParallelExecution, MatchesSequentialExecution)
+{
+    const auto data = random_values(100'003);
+    const auto statistics = all_statistics();
+
+    Results expected;
+    SequentialExecution{}.run(*statistics, data, expected);
+
+    const Results results = run_parallel(*statistics, data, 4, 1000);
+
+    ASSERT_EQ(results.size(), expected.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        ASSERT_EQ(results[i].description, expected[i].description);
+        ASSERT_NEAR(results[i].value, expected[i].value, 1e-9 * std::abs(expected[i].value)) << results[i].description;
+    }
+}
+
+TEST(ParallelExecution, SmallDataRunsOnCallingThread)
+{
+    const Data data{1.0, 2.0, 3.0};
+
+    const Results results = run_parallel(Average{}, data, 4, 1000);
+
+    ASSERT_EQ(results.size(), 1u);
+    ASSERT_EQ(results[0].value, 2.0);
+}
+
+TEST(ParallelExecution, ErrorIsRethrownAfterAllWorkersFinished)
+{
+    Data data(64 * 100, 1.0);
+    data[64 * 3] = -1.0; // first value of the fourth chunk
+
+    auto thread_pool = std::make_shared<ThreadPool>(8); // outlives run() - its threads are not joined before the check
+    ParallelExecution execution{thread_pool, 64};
+    Results results;
+
+    ASSERT_THROW(execution.run(FailingChunk{}, data, results), std::runtime_error);
+    ASSERT_EQ(FailingChunk::running.load(), 0);
+}
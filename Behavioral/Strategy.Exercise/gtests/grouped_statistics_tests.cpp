@@ -0,0 +1,187 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "grouped_statistics.hpp"
+
+using namespace ::testing;
+using namespace Version_1;
+
+namespace
+{
+    bool fail_new_groups = false;
+
+    // sum of the values - accumulators are allocated one by one, the creation of one fails on demand
+    class AllocatedSum : public Statistics
+    {
+    public:
+        class Accumulator : public Version_1::Accumulator
+        {
+            double sum_{};
+
+        public:
+            void update(const double* first, const double* last) override
+            {
+                for (; first != last; ++first)
+                    sum_ += *first;
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                sum_ += static_cast<const Accumulator&>(other).sum_;
+            }
+
+            void get_results(Results& results) const override
+            {
+                results.push_back(StatResult("Sum", sum_));
+            }
+        };
+
+        void calculate(DataView data, Results& results) const override
+        {
+            Accumulator accumulator;
+            accumulator.update(data.data(), data.data() + data.size());
+            accumulator.get_results(results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            if (fail_new_groups)
+                throw std::bad_alloc{};
+
+            return std::make_unique<Accumulator>();
+        }
+    };
+
+    // sum of the values - accumulators are cloned in place, the copy fails on demand
+    class ClonedSum : public Statistics
+    {
+    public:
+        class Accumulator : public CloneableAccumulator<Accumulator>
+        {
+            double sum_{};
+
+        public:
+            Accumulator() = default;
+
+            Accumulator(const Accumulator& other)
+                : sum_{other.sum_}
+            {
+                if (fail_new_groups)
+                    throw std::bad_alloc{};
+            }
+
+            void update(const double* first, const double* last) override
+            {
+                for (; first != last; ++first)
+                    sum_ += *first;
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                sum_ += static_cast<const Accumulator&>(other).sum_;
+            }
+
+            void get_results(Results& results) const override
+            {
+                results.push_back(StatResult("Sum", sum_));
+            }
+        };
+
+        void calculate(DataView data, Results& results) const override
+        {
+            Accumulator accumulator;
+            accumulator.update(data.data(), data.data() + data.size());
+            accumulator.get_results(results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>();
+        }
+    };
+
+    std::vector<std::pair<std::string, double>> sums_of(GroupedStatistics& grouped)
+    {
+        std::vector<std::pair<std::string, double>> sums;
+        for (const auto& group : grouped.results())
+            sums.emplace_back(group.key, group.results.at(0).value);
+        return sums;
+    }
+
+    class GroupedStatistics_FailedGroup : public Test
+    {
+    protected:
+        void TearDown() override
+        {
+            fail_new_groups = false;
+        }
+
+        // a failed new group must not leave its key behind - the next key would get a group without a slot
+        void expect_groups_intact(const Statistics& statistics)
+        {
+            GroupedStatistics grouped{statistics};
+            grouped.add("a", 1.0);
+            grouped.add("b", 2.0);
+
+            fail_new_groups = true;
+            ASSERT_THROW(grouped.add("c", 3.0), std::bad_alloc);
+            grouped.add("a", 10.0);
+            fail_new_groups = false;
+
+            ASSERT_EQ(grouped.group_count(), 2u);
+
+            for (int i = 0; i < 20; ++i)
+                grouped.add("d", 1.0);
+            grouped.add("c", 4.0);
+
+            ASSERT_THAT(sums_of(grouped),
+                ElementsAre(Pair("a", 11.0), Pair("b", 2.0), Pair("d", 20.0), Pair("c", 4.0)));
+        }
+    };
+} // namespace
+
+TEST(GroupedStatistics, KeepsGroupsInOrderOfFirstAppearance)
+{
+    ClonedSum statistics;
+    GroupedStatistics grouped{statistics};
+
+    ASSERT_TRUE(grouped.add_text("b 1 a 2 b 3 a_much_longer_key_than_the_slot_prefix 4 b 5"));
+
+    ASSERT_THAT(sums_of(grouped),
+        ElementsAre(Pair("b", 9.0), Pair("a", 2.0), Pair("a_much_longer_key_than_the_slot_prefix", 4.0)));
+}
+
+TEST(GroupedStatistics, KeepsManyGroupsApart)
+{
+    ClonedSum statistics;
+    GroupedStatistics grouped{statistics};
+
+    const int key_count = 5000; // several blocks of slots & several growths of the index
+    for (int round = 1; round <= 10; ++round)
+        for (int key = 0; key < key_count; ++key)
+            grouped.add(std::to_string(key), key * round);
+
+    const auto sums = sums_of(grouped);
+    ASSERT_EQ(sums.size(), static_cast<size_t>(key_count));
+    for (int key = 0; key < key_count; ++key)
+    {
+        ASSERT_EQ(sums[key].first, std::to_string(key));
+        ASSERT_EQ(sums[key].second, key * 55.0);
+    }
+}
+
+TEST_F(GroupedStatistics_FailedGroup, LeavesGroupsIntactForAllocatedAccumulators)
+{
+    AllocatedSum statistics;
+    expect_groups_intact(statistics);
+}
+
+TEST_F(GroupedStatistics_FailedGroup, LeavesGroupsIntactForClonedAccumulators)
+{
+    ClonedSum statistics;
+    expect_groups_intact(statistics);
+}
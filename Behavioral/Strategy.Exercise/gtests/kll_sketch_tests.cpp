@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "kll_sketch.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    constexpr size_t value_count = 1'000'000;
+
+    // 0, 1, ..., n - 1 in random order - the rank of a value is the value itself
+    std::vector<double> shuffled_ranks(size_t n)
+    {
+        std::vector<double> values(n);
+        std::iota(values.begin(), values.end(), 0.0);
+        std::shuffle(values.begin(), values.end(), std::mt19937_64{42});
+        return values;
+    }
+
+    // normalized rank error of the sketch's answer for q
+    double rank_error(const KllSketch& sketch, double q)
+    {
+        return std::abs(sketch.quantile(q) / value_count - q);
+    }
+
+    // documented error of about 1.7 / k, with headroom for a single unlucky quantile
+    double error_bound(size_t k)
+    {
+        return 2 * 1.7 / k;
+    }
+
+    const std::vector<double> tested_quantiles{0.01, 0.05, 0.1, 0.25, 0.5, 0.75, 0.9, 0.95, 0.99};
+} // namespace
+
+TEST(KllSketch, EmptySketchHasNoQuantiles)
+{
+    KllSketch sketch;
+
+    ASSERT_EQ(sketch.count(), 0u);
+    ASSERT_TRUE(std::isnan(sketch.quantile(0.5)));
+}
+
+TEST(KllSketch, SmallInputIsExact)
+{
+    KllSketch sketch;
+    for (double value : {5.0, 1.0, 4.0, 2.0, 3.0})
+        sketch.add(value);
+
+    ASSERT_EQ(sketch.quantile(0.0), 1.0);
+    ASSERT_EQ(sketch.quantile(0.5), 3.0);
+    ASSERT_EQ(sketch.quantile(1.0), 5.0);
+}
+
+TEST(KllSketch, NanIsIgnored)
+{
+    KllSketch sketch;
+    sketch.add(1.0);
+    sketch.add(std::numeric_limits<double>::quiet_NaN());
+
+    ASSERT_EQ(sketch.count(), 1u);
+    ASSERT_EQ(sketch.quantile(0.5), 1.0);
+}
+
+TEST(KllSketch, RankErrorIsBounded)
+{
+    const auto values = shuffled_ranks(value_count);
+
+    for (size_t k : {size_t{100}, KllSketch::default_k, size_t{400}})
+    {
+        KllSketch sketch{k};
+        sketch.add(values.data(), values.data() + values.size());
+
+        ASSERT_EQ(sketch.count(), value_count);
+        ASSERT_EQ(sketch.quantile(0.0), 0.0);
+        ASSERT_EQ(sketch.quantile(1.0), value_count - 1.0);
+
+        for (double q : tested_quantiles)
+            ASSERT_LE(rank_error(sketch, q), error_bound(k)) << "k = " << k << ", q = " << q;
+    }
+}
+
+TEST(KllSketch, MemoryIsBoundedByK)
+{
+    const auto values = shuffled_ranks(value_count);
+
+    KllSketch sketch;
+    sketch.add(values.data(), values.data() + values.size());
+
+    ASSERT_LE(sketch.retained(), 4 * KllSketch::default_k);
+}
+
+TEST(KllSketch, MergedSketchesKeepRankErrorBound)
+{
+    const auto values = shuffled_ranks(value_count);
+    constexpr size_t parts = 8;
+
+    KllSketch merged;
+    for (size_t part = 0; part < parts; ++part)
+    {
+        KllSketch sketch;
+        sketch.add(values.data() + part * value_count / parts, values.data() + (part + 1) * value_count / parts);
+        merged.merge(sketch);
+    }
+
+    ASSERT_EQ(merged.count(), value_count);
+    ASSERT_LE(merged.retained(), 4 * KllSketch::default_k);
+    for (double q : tested_quantiles)
+        ASSERT_LE(rank_error(merged, q), error_bound(KllSketch::default_k)) << "q = " << q;
+}
+
+TEST(KllSketch, SameInputGivesSameAnswers)
+{
+    const auto values = shuffled_ranks(100'000);
+
+    KllSketch first;
+    KllSketch second;
+    first.add(values.data(), values.data() + values.size());
+    second.add(values.data(), values.data() + values.size());
+
+    ASSERT_EQ(first.quantiles(tested_quantiles), second.quantiles(tested_quantiles));
+}
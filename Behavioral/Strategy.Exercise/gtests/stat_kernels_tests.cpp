@@ -0,0 +1,97 @@
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "stat_kernels.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    // magnitudes spread over many orders, so any change of the summation order changes the sum
+    std::vector<double> random_values(size_t size, unsigned seed)
+    {
+        std::mt19937_64 rnd{seed};
+        std::uniform_real_distribution<double> mantissa{-1.0, 1.0};
+        std::uniform_int_distribution<int> exponent{-20, 20};
+
+        std::vector<double> values(size);
+        for (auto& value : values)
+            value = std::ldexp(mantissa(rnd), exponent(rnd));
+        return values;
+    }
+
+    bool bit_equal(double a, double b)
+    {
+        return std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+} // namespace
+
+TEST(StatKernels, DispatchMatchesCpuSupport)
+{
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    ASSERT_EQ(StatKernels::uses_avx2(), static_cast<bool>(__builtin_cpu_supports("avx2")));
+#else
+    ASSERT_FALSE(StatKernels::uses_avx2());
+#endif
+}
+
+TEST(StatKernels, SumIsBitIdenticalToScalarKernel)
+{
+    // sizes around the block, lane & pairwise split boundaries
+    for (size_t size : {1u, 7u, 15u, 16u, 17u, 255u, 256u, 257u, 1000u, 4097u, 100'003u})
+    {
+        const auto values = random_values(size, static_cast<unsigned>(size));
+
+        const double sum = StatKernels::sum(values.data(), values.size());
+        const double scalar_sum = StatKernels::Scalar::sum(values.data(), values.size());
+
+        ASSERT_TRUE(bit_equal(sum, scalar_sum)) << "size " << size << ": " << sum << " != " << scalar_sum;
+    }
+}
+
+TEST(StatKernels, SumOfEmptyRangeIsZero)
+{
+    ASSERT_EQ(StatKernels::sum(nullptr, 0), 0.0);
+}
+
+TEST(StatKernels, MinMaxMatchesScalarKernel)
+{
+    for (size_t size : {1u, 7u, 8u, 9u, 15u, 16u, 17u, 1000u, 100'003u})
+    {
+        const auto values = random_values(size, static_cast<unsigned>(size) + 1);
+
+        const auto [min, max] = StatKernels::min_max(values.data(), values.size());
+        const auto [scalar_min, scalar_max] = StatKernels::Scalar::min_max(values.data(), values.size());
+
+        ASSERT_EQ(min, scalar_min) << "size " << size;
+        ASSERT_EQ(max, scalar_max) << "size " << size;
+    }
+}
+
+TEST(StatKernels, MinMaxFindsExtremesInTail)
+{
+    std::vector<double> values(19, 1.0);
+    values.back() = -5.0;
+    values[values.size() - 2] = 7.0;
+
+    const auto [min, max] = StatKernels::min_max(values.data(), values.size());
+
+    ASSERT_EQ(min, -5.0);
+    ASSERT_EQ(max, 7.0);
+}
+
+TEST(StatKernels, SummarizeCombinesKernels)
+{
+    const std::vector<double> values{3.0, -1.0, 4.0, 1.5};
+
+    const auto summary = StatKernels::summarize(values.data(), values.size());
+
+    ASSERT_EQ(summary.min, -1.0);
+    ASSERT_EQ(summary.max, 4.0);
+    ASSERT_EQ(summary.sum, 7.5);
+}
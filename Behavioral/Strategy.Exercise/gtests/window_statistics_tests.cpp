@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "data_analyzer.hpp"
+#include "execution_policy.hpp"
+#include "window_statistics.hpp"
+
+using namespace ::testing;
+using namespace Version_1;
+
+namespace
+{
+    std::shared_ptr<Statistics> std_statistics()
+    {
+        return std::make_shared<StatGroup>(std::initializer_list<std::shared_ptr<Statistics>>{
+                                               std::make_shared<Average>(), std::make_shared<MinMax>(), std::make_shared<Sum>()},
+            ExecutionMode::fused);
+    }
+
+    std::vector<double> values_of(const Results& results)
+    {
+        std::vector<double> values;
+        for (const auto& result : results)
+            values.push_back(result.value);
+        return values;
+    }
+
+    // Avg, Min, Max & Sum of [first, last) computed directly
+    std::vector<double> expected_values(const double* first, const double* last)
+    {
+        const double sum = std::accumulate(first, last, 0.0);
+        return {sum / (last - first), *std::min_element(first, last), *std::max_element(first, last), sum};
+    }
+} // namespace
+
+TEST(SlidingWindow, CountBasedKeepsLastValues)
+{
+    const auto stats = std_statistics();
+    auto window = SlidingWindow::count_based(*stats, 3);
+
+    for (double value : {5.0, 1.0, 4.0, 2.0, 8.0})
+        window.push(value);
+
+    ASSERT_EQ(window.size(), 3u);
+    ASSERT_THAT(values_of(window.results()), ElementsAre(DoubleEq(14.0 / 3), 2.0, 8.0, 14.0));
+}
+
+TEST(SlidingWindow, MatchesRecomputationOverRandomSeries)
+{
+    std::mt19937_64 rnd{7};
+    std::uniform_real_distribution<double> distribution{-1000.0, 1000.0};
+    std::vector<double> data(5000);
+    std::generate(data.begin(), data.end(), [&] { return distribution(rnd); });
+
+    const auto stats = std_statistics();
+    for (size_t size : {1u, 2u, 17u, 256u})
+    {
+        auto window = SlidingWindow::count_based(*stats, size);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            window.push(data[i]);
+
+            const size_t first = i + 1 > size ? i + 1 - size : 0;
+            const auto expected = expected_values(data.data() + first, data.data() + i + 1);
+            const auto actual = values_of(window.results());
+
+            ASSERT_NEAR(actual[0], expected[0], 1e-9) << "size " << size << ", value " << i;
+            ASSERT_EQ(actual[1], expected[1]) << "size " << size << ", value " << i;
+            ASSERT_EQ(actual[2], expected[2]) << "size " << size << ", value " << i;
+            ASSERT_NEAR(actual[3], expected[3], 1e-9 * size) << "size " << size << ", value " << i;
+        }
+    }
+}
+
+TEST(SlidingWindow, TimeBasedKeepsValuesWithinDuration)
+{
+    const auto stats = std_statistics();
+    auto window = SlidingWindow::time_based(*stats, 10.0);
+
+    window.push(1.0, 0.0);
+    window.push(2.0, 5.0);
+    window.push(3.0, 10.0); // 0.0 is 10 behind - evicted
+    ASSERT_EQ(window.size(), 2u);
+
+    window.push(4.0, 30.0);
+    ASSERT_EQ(window.size(), 1u);
+    ASSERT_THAT(values_of(window.results()), ElementsAre(4.0, 4.0, 4.0, 4.0));
+}
+
+TEST(SlidingWindow, NewestValueStaysWhenDurationIsBelowTimestampPrecision)
+{
+    const auto stats = std_statistics();
+    auto window = SlidingWindow::time_based(*stats, 1e-3);
+
+    window.push(1.0, 1e300);
+    window.push(2.0, 1e300);
+
+    ASSERT_EQ(window.size(), 1u);
+    ASSERT_THAT(values_of(window.results()), ElementsAre(2.0, 2.0, 2.0, 2.0));
+}
+
+TEST(SlidingWindow, NonFiniteTimestampsAreRejected)
+{
+    const auto stats = std_statistics();
+    auto window = SlidingWindow::time_based(*stats, 10.0);
+    window.push(1.0, 0.0);
+
+    ASSERT_THROW(window.push(2.0, std::numeric_limits<double>::infinity()), std::invalid_argument);
+    ASSERT_THROW(window.push(2.0, std::numeric_limits<double>::quiet_NaN()), std::invalid_argument);
+    ASSERT_EQ(window.size(), 1u);
+
+    auto count_window = SlidingWindow::count_based(*stats, 10);
+    ASSERT_THROW(count_window.push(2.0, -std::numeric_limits<double>::infinity()), std::invalid_argument);
+}
+
+TEST(SlidingWindow, TimeBasedRejectsDecreasingTimestamps)
+{
+    const auto stats = std_statistics();
+    auto window = SlidingWindow::time_based(*stats, 10.0);
+    window.push(1.0, 5.0);
+
+    ASSERT_THROW(window.push(2.0, 4.0), std::invalid_argument);
+}
+
+TEST(SlidingWindow, CountBasedIgnoresTimestampOrder)
+{
+    const auto stats = std_statistics();
+    auto window = SlidingWindow::count_based(*stats, 2);
+    window.push(1.0, 5.0);
+    window.push(2.0, 4.0);
+    window.push(3.0, 1.0);
+
+    ASSERT_THAT(values_of(window.results()), ElementsAre(2.5, 2.0, 3.0, 5.0));
+}
+
+TEST(SlidingWindow, NanValuesAreIgnored)
+{
+    const auto stats = std_statistics();
+    auto window = SlidingWindow::count_based(*stats, 2);
+    window.push(1.0);
+    window.push(std::numeric_limits<double>::quiet_NaN());
+    window.push(3.0);
+
+    ASSERT_THAT(values_of(window.results()), ElementsAre(2.0, 1.0, 3.0, 4.0));
+}
+
+TEST(SlidingWindow, EmptyWindowHasNanResults)
+{
+    const auto stats = std_statistics();
+    const auto window = SlidingWindow::count_based(*stats, 2);
+
+    const auto values = values_of(window.results());
+    ASSERT_TRUE(std::isnan(values[0]));
+    ASSERT_TRUE(std::isnan(values[1]));
+    ASSERT_TRUE(std::isnan(values[2]));
+    ASSERT_EQ(values[3], 0.0);
+}
+
+TEST(SlidingWindow, StatisticsThatAreNotWindowAwareAreRejected)
+{
+    const Variance variance;
+
+    ASSERT_THROW(SlidingWindow::count_based(variance, 10), std::invalid_argument);
+    ASSERT_THROW(SlidingWindow::count_based(Sum{}, 0), std::invalid_argument);
+    ASSERT_THROW(SlidingWindow::time_based(Sum{}, 0.0), std::invalid_argument);
+}
+
+TEST(WindowedStatistics, DataAnalyzerComputesLastValues)
+{
+    DataAnalyzer da{std::make_shared<WindowedStatistics>(std_statistics(), 3)};
+    da.append(Data{5.0, 1.0, 4.0, 2.0, 8.0});
+    da.calculate();
+
+    ASSERT_THAT(values_of(da.results()), ElementsAre(DoubleEq(14.0 / 3), 2.0, 8.0, 14.0));
+}
+
+TEST(WindowedStatistics, AppendSlidesWindow)
+{
+    DataAnalyzer da{std::make_shared<WindowedStatistics>(std_statistics(), 3)};
+    da.append(Data{5.0, 1.0, 4.0});
+    da.calculate();
+
+    da.append(Data{10.0, 0.5});
+
+    ASSERT_THAT(values_of(da.results()), ElementsAre(DoubleEq(14.5 / 3), 0.5, 10.0, 14.5));
+}
+
+TEST(WindowedStatistics, ParallelExecutionMergesWindows)
+{
+    Data data(10'000);
+    std::iota(data.begin(), data.end(), 0.0);
+    const WindowedStatistics stats{std_statistics(), 1500};
+
+    Results expected;
+    stats.calculate(data, expected);
+
+    ParallelExecution execution{std::make_shared<ThreadPool>(4), 1000};
+    Results results;
+    execution.run(stats, data, results);
+
+    ASSERT_THAT(values_of(results), ElementsAreArray(values_of(expected)));
+    ASSERT_THAT(values_of(results), ElementsAre(9249.5, 8500.0, 9999.0, 9249.5 * 1500));
+}
+
+TEST(WindowedStatistics, ComposesWithOtherStatistics)
+{
+    const StatGroup group{{std::make_shared<WindowedStatistics>(std::make_shared<Sum>(), 2), std::make_shared<Sum>()}, ExecutionMode::fused};
+    const Data data{1.0, 2.0, 3.0, 4.0};
+
+    Results results;
+    group.calculate(data, results);
+
+    ASSERT_THAT(values_of(results), ElementsAre(7.0, 10.0));
+}
@@ -0,0 +1,139 @@
+#include "kll_sketch.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    constexpr double capacity_decay = 2.0 / 3.0;
+    constexpr size_t min_capacity = 2;
+} // namespace
+
+KllSketch::KllSketch(size_t k)
+    : k_{k}
+{
+    if (k_ < min_capacity)
+        throw std::invalid_argument("KLL sketch parameter k must be at least 2");
+
+    grow();
+}
+
+void KllSketch::grow()
+{
+    levels_.emplace_back();
+    compaction_offsets_.push_back(0);
+
+    // the top level has capacity k, every level below 2/3 of the one above it
+    const size_t height = levels_.size();
+    capacities_.resize(height);
+    max_size_ = 0;
+    for (size_t h = 0; h < height; ++h)
+    {
+        const double depth = static_cast<double>(height - 1 - h);
+        capacities_[h] = std::max(min_capacity, static_cast<size_t>(std::ceil(k_ * std::pow(capacity_decay, depth))));
+        max_size_ += capacities_[h];
+    }
+}
+
+// sorts the level and promotes every other value - with twice the weight - to the level above
+void KllSketch::compact(size_t level)
+{
+    auto& values = levels_[level];
+    auto& next_values = levels_[level + 1];
+
+    std::sort(values.begin(), values.end());
+
+    // with an odd size the largest value stays, so the total weight is preserved exactly
+    const bool odd = values.size() % 2 != 0;
+    const double leftover = odd ? values.back() : 0.0;
+    const size_t even_size = values.size() - odd;
+
+    const size_t offset = compaction_offsets_[level];
+    compaction_offsets_[level] ^= 1;
+
+    for (size_t i = offset; i < even_size; i += 2)
+        next_values.push_back(values[i]);
+
+    values.clear();
+    if (odd)
+        values.push_back(leftover);
+
+    size_ -= even_size / 2;
+}
+
+void KllSketch::compress()
+{
+    for (size_t h = 0; h < levels_.size(); ++h)
+    {
+        if (levels_[h].size() >= capacities_[h])
+        {
+            if (h + 1 == levels_.size())
+                grow();
+
+            compact(h);
+
+            if (size_ < max_size_)
+                break;
+        }
+    }
+}
+
+void KllSketch::merge(const KllSketch& other)
+{
+    while (levels_.size() < other.levels_.size())
+        grow();
+
+    for (size_t h = 0; h < other.levels_.size(); ++h)
+        levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+
+    size_ += other.size_;
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+
+    while (size_ >= max_size_)
+        compress();
+}
+
+double KllSketch::quantile(double q) const
+{
+    return quantiles(std::span<const double>{&q, 1}).front();
+}
+
+std::vector<double> KllSketch::quantiles(std::span<const double> qs) const
+{
+    std::vector<double> results(qs.size(), std::numeric_limits<double>::quiet_NaN());
+    if (count_ == 0)
+        return results;
+
+    std::vector<std::pair<double, std::uint64_t>> weighted; // value & weight
+    weighted.reserve(size_);
+    for (size_t h = 0; h < levels_.size(); ++h)
+        for (const double value : levels_[h])
+            weighted.emplace_back(value, std::uint64_t{1} << h);
+
+    std::sort(weighted.begin(), weighted.end());
+
+    for (size_t i = 1; i < weighted.size(); ++i)
+        weighted[i].second += weighted[i - 1].second; // cumulative weight
+
+    for (size_t i = 0; i < qs.size(); ++i)
+    {
+        const double q = std::clamp(qs[i], 0.0, 1.0);
+
+        if (q == 0.0)
+            results[i] = min_;
+        else if (q == 1.0)
+            results[i] = max_;
+        else
+        {
+            const double rank = q * count_;
+            auto it = std::lower_bound(weighted.begin(), weighted.end(), rank,
+                [](const auto& item, double r) { return item.second < r; });
+            results[i] = it != weighted.end() ? it->first : max_;
+        }
+    }
+
+    return results;
+}
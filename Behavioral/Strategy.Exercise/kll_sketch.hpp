@@ -0,0 +1,78 @@
+#ifndef KLL_SKETCH_HPP
+#define KLL_SKETCH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+// KLL quantile sketch (Karnin, Lang, Liberty) - keeps about 3k values whatever the number
+// of values added; rank error is roughly 1.7 / k. Sketches of separate parts of the data merge.
+// Compaction keeps alternately the even and the odd positions of a sorted level instead of
+// a random choice, so the same input and merge order always give the same answer.
+class KllSketch
+{
+    size_t k_;
+    std::vector<std::vector<double>> levels_; // a value at level h stands for 2^h input values
+    std::vector<size_t> capacities_;
+    std::vector<unsigned char> compaction_offsets_;
+    size_t size_{};     // values retained on all levels
+    size_t max_size_{}; // sum of level capacities
+    std::uint64_t count_{};
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+
+public:
+    static constexpr size_t default_k = 200;
+
+    explicit KllSketch(size_t k = default_k);
+
+    // NaN values are ignored
+    void add(double value)
+    {
+        if (std::isnan(value))
+            return;
+
+        ++count_;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+
+        levels_.front().push_back(value);
+        if (++size_ >= max_size_)
+            compress();
+    }
+
+    void add(const double* first, const double* last)
+    {
+        for (; first != last; ++first)
+            add(*first);
+    }
+
+    void merge(const KllSketch& other);
+
+    std::uint64_t count() const
+    {
+        return count_;
+    }
+
+    size_t retained() const
+    {
+        return size_;
+    }
+
+    // q in [0, 1]; 0 and 1 give the exact min and max, NaN for an empty sketch
+    double quantile(double q) const;
+
+    // one sort of the retained values for all of qs
+    std::vector<double> quantiles(std::span<const double> qs) const;
+
+private:
+    void grow();
+    void compress();
+    void compact(size_t level);
+};
+
+#endif // KLL_SKETCH_HPP
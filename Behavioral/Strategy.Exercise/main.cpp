@@ -1,3 +1,11 @@
+#include "batch_analyzer.hpp"
+#include "data_analyzer.hpp"
+#include "distribution_statistics.hpp"
+#include "execution_policy.hpp"
+#include "stat_kernels.hpp"
+#include "statistics.hpp"
+#include "window_statistics.hpp"
+
 #include <algorithm>
 #include <fstream>
 #include <functional>
@@ -12,144 +20,66 @@
 
 namespace Version_1
 {
-    struct StatResult
-    {
-        std::string description;
-        double value;
-
-        StatResult(const std::string& desc, double val)
-            : description(desc)
-            , value(val)
-        {
-        }
-    };
-
-    using Data = std::vector<double>;
-    using Results = std::vector<StatResult>;
-
-    class Statistics
+    void show_results(const Results& results)
     {
-    public:
-        virtual ~Statistics() = default;
-        virtual void calculate(const Data& data, Results& result) const = 0;
-    };
+        for (const auto& rslt : results)
+            std::cout << rslt.description << " = " << rslt.value << std::endl;
+    }
 
-    class Average : public Statistics
+    int main()
     {
-    public:
-        void calculate(const Data& data, Results& results) const override
-        {
-            double sum = std::accumulate(data.begin(), data.end(), 0.0);
-            double avg = sum / data.size();
-            results.push_back(StatResult("Avg", avg));
-        }
-    };
+        std::shared_ptr<Statistics> avg = std::make_shared<Average>();
+        std::shared_ptr<Statistics> min_max = std::make_shared<MinMax>();
+        std::shared_ptr<Statistics> sum = std::make_shared<Sum>();
 
-    class MinMax : public Statistics
-    {
-    public:
-        void calculate(const Data& data, Results& results) const override
-        {
-            double min = *(std::min_element(data.begin(), data.end()));
-            double max = *(std::max_element(data.begin(), data.end()));
-            results.push_back(StatResult("Min", min));
-            results.push_back(StatResult("Max", max));
-        }
-    };
+        auto list_of_stats = {avg, min_max, sum};
+        auto std_statistics = std::make_shared<StatGroup>(list_of_stats, ExecutionMode::fused);
 
-    class Sum : public Statistics
-    {
-    public:
-        void calculate(const Data& data, Results& results) const override
-        {
-            double sum = std::accumulate(data.begin(), data.end(), 0.0);
-            results.push_back(StatResult("Sum", sum));
-        }
-    };
+        auto thread_pool = std::make_shared<ThreadPool>();
+        DataAnalyzer da{avg, std::make_shared<ParallelExecution>(thread_pool)};
+        da.load_data("stats_data.dat");
+        da.calculate();
 
-    class StatGroup : public Statistics
-    {
-        std::vector<std::shared_ptr<Statistics>> statistics_;
-    public:
-        StatGroup(std::initializer_list<std::shared_ptr<Statistics>> strategies)
-            : statistics_{strategies}
-        {
-        }
+        show_results(da.results());
 
-        void calculate(const Data& data, Results& results) const override
-        {
-            for (const auto& stat : statistics_)
-            {
-                stat->calculate(data, results);
-            }
-        }
-    };
+        std::cout << "\n\n";
 
-    class DataAnalyzer
-    {
-        std::shared_ptr<Statistics> strategy_;
-        Data data_;
-        Results results_;
+        da.load_data("new_stats_data.dat");
+        da.calculate();
 
-    public:
-        explicit DataAnalyzer(std::shared_ptr<Statistics> strategy)
-            : strategy_{std::move(strategy)}
-        {
-        }
+        show_results(da.results());
 
-        void load_data(const std::string& file_name)
-        {
-            data_.clear();
-            results_.clear();
+        std::cout << "\n\n";
 
-            std::ifstream fin(file_name.c_str());
-            if (!fin)
-                throw std::runtime_error("File not opened");
+        da.set_statistics(std_statistics);
+        da.save_column_file("new_stats_data.col");
+        da.load_column_file("new_stats_data.col");
+        da.calculate();
 
-            double d;
-            while (fin >> d)
-            {
-                data_.push_back(d);
-            }
+        show_results(da.results());
 
-            std::cout << "File " << file_name << " has been loaded...\n";
-        }
+        std::cout << "\n\n";
 
-        void set_statistics(std::shared_ptr<Statistics> strategy)
-        {
-            strategy_ = strategy;
-        }
+        da.append(Data{150.0, -20.0, 35.5});
+        std::cout << "3 values appended...\n";
 
-        void calculate()
-        {
-            if (strategy_)
-            {
-                strategy_->calculate(data_, results_);
-            }
-        }
+        show_results(da.results());
 
-        const Results& results() const
-        {
-            return results_;
-        }
-    };
+        std::cout << "\n\n";
 
-    void show_results(const Results& results)
-    {
-        for (const auto& rslt : results)
-            std::cout << rslt.description << " = " << rslt.value << std::endl;
-    }
+        std::shared_ptr<Statistics> variance = std::make_shared<Variance>();
+        auto streamed_stats = {avg, min_max, sum, variance};
+        da.set_statistics(std::make_shared<StatGroup>(streamed_stats, ExecutionMode::fused));
+        da.stream_data("stats_data.dat");
 
-    int main()
-    {
-        std::shared_ptr<Statistics> avg = std::make_shared<Average>();
-        std::shared_ptr<Statistics> min_max = std::make_shared<MinMax>();
-        std::shared_ptr<Statistics> sum = std::make_shared<Sum>();
+        show_results(da.results());
 
-        auto list_of_stats = {avg, min_max, sum};
-        auto std_statistics = std::make_shared<StatGroup>(list_of_stats);
+        std::cout << "\n\n";
 
-        DataAnalyzer da{avg};
+        std::shared_ptr<Statistics> quantiles = std::make_shared<Quantiles>();
+        std::shared_ptr<Statistics> histogram = std::make_shared<Histogram>(0.0, 100.0, 5);
+        auto distribution_stats = {quantiles, histogram};
+        da.set_statistics(std::make_shared<StatGroup>(distribution_stats, ExecutionMode::fused));
         da.load_data("stats_data.dat");
         da.calculate();
 
@@ -157,10 +87,41 @@ namespace Version_1
 
         std::cout << "\n\n";
 
-        da.load_data("new_stats_data.dat");
-        da.calculate();
+        auto window = SlidingWindow::count_based(*std_statistics, 10);
+        for (const auto& value : DataLoader::load_file("stats_data.dat"))
+            window.push(value);
 
-        show_results(da.results());
+        std::cout << "Last " << window.size() << " values of stats_data.dat:\n";
+        show_results(window.results());
+
+        std::cout << "\n\n";
+
+        da.set_statistics(std_statistics);
+        da.analyze_grouped("grouped_stats_data.dat");
+
+        for (const auto& group : da.grouped_results())
+        {
+            std::cout << "[" << group.key << "]\n";
+            show_results(group.results);
+        }
+
+        std::cout << "\n\n";
+
+        BatchAnalyzer batch{std_statistics};
+        batch.run({"stats_data.dat", "new_stats_data.dat", "missing.dat"}, [](const FileResults& file) {
+            try
+            {
+                if (file.error)
+                    std::rethrow_exception(file.error);
+
+                std::cout << "File " << file.file_name << " has been analyzed...\n";
+                show_results(file.results);
+            }
+            catch (const std::exception& e)
+            {
+                std::cout << "File " << file.file_name << " failed: " << e.what() << "\n";
+            }
+        });
 
         return 0;
     }
@@ -238,7 +199,7 @@ namespace Version_2
     {
         Results operator()(const Data& data) const
         {
-            double sum = std::accumulate(data.begin(), data.end(), 0.0);
+            double sum = StatKernels::sum(data.data(), data.size());
             double avg = sum / data.size();
 
             StatResult result("Avg", avg);
@@ -250,8 +211,7 @@ namespace Version_2
     {
         Results operator()(const Data& data) const
         {
-            double min = *(std::min_element(data.begin(), data.end()));
-            double max = *(std::max_element(data.begin(), data.end()));
+            auto [min, max] = StatKernels::min_max(data.data(), data.size());
             return {StatResult("Min", min), StatResult("Max", max)};
         }
     };
@@ -260,7 +220,7 @@ namespace Version_2
     {
         Results operator()(const Data& data) const
         {
-            double sum = std::accumulate(data.begin(), data.end(), 0.0);
+            double sum = StatKernels::sum(data.data(), data.size());
             return {StatResult("Sum", sum)};
         }
     };
@@ -315,6 +275,26 @@ namespace Version_2
 
         show_results(da.results());
 
+        std::cout << "\n\n";
+
+        const std::vector<std::string> file_names{"stats_data.dat", "new_stats_data.dat"};
+        std::vector<Results> file_results(file_names.size());
+
+        Version_1::BasicBatchAnalyzer<Results> batch{
+            [&advanced_statistics](const Data& data, Results& results) { results = advanced_statistics(data); }};
+        batch.run(file_names, [&file_results](const Version_1::BasicFileResults<Results>& file) {
+            if (file.error)
+                std::rethrow_exception(file.error);
+
+            file_results[file.index] = file.results;
+        });
+
+        for (size_t i = 0; i < file_names.size(); ++i)
+        {
+            std::cout << "File " << file_names[i] << " has been analyzed...\n";
+            show_results(file_results[i]);
+        }
+
         return 0;
     }
 }
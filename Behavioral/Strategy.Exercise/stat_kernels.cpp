@@ -0,0 +1,179 @@
+#include "stat_kernels.hpp"
+
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define STAT_KERNELS_AVX2
+#endif
+
+namespace
+{
+    constexpr size_t lanes = 16;             // partial sums kept by the block kernels
+    constexpr size_t pairwise_block = 256;   // below this size a block kernel runs directly
+
+    // element i is added to partial sum i % 16; partials are combined as a fixed tree
+    double sum_block_scalar(const double* data, size_t size)
+    {
+        double partial[lanes] = {};
+
+        size_t i = 0;
+        for (; i + lanes <= size; i += lanes)
+            for (size_t lane = 0; lane < lanes; ++lane)
+                partial[lane] += data[i + lane];
+
+        double t[4];
+        for (size_t lane = 0; lane < 4; ++lane)
+            t[lane] = (partial[lane] + partial[4 + lane]) + (partial[8 + lane] + partial[12 + lane]);
+
+        double result = (t[0] + t[2]) + (t[1] + t[3]);
+
+        for (; i < size; ++i)
+            result += data[i];
+
+        return result;
+    }
+
+    StatKernels::MinMaxValues min_max_scalar(const double* data, size_t size)
+    {
+        auto [min, max] = std::minmax_element(data, data + size);
+        return {*min, *max};
+    }
+
+#ifdef STAT_KERNELS_AVX2
+    __attribute__((target("avx2"))) double sum_block_avx2(const double* data, size_t size)
+    {
+        __m256d v0 = _mm256_setzero_pd();
+        __m256d v1 = _mm256_setzero_pd();
+        __m256d v2 = _mm256_setzero_pd();
+        __m256d v3 = _mm256_setzero_pd();
+
+        size_t i = 0;
+        for (; i + lanes <= size; i += lanes)
+        {
+            v0 = _mm256_add_pd(v0, _mm256_loadu_pd(data + i));
+            v1 = _mm256_add_pd(v1, _mm256_loadu_pd(data + i + 4));
+            v2 = _mm256_add_pd(v2, _mm256_loadu_pd(data + i + 8));
+            v3 = _mm256_add_pd(v3, _mm256_loadu_pd(data + i + 12));
+        }
+
+        const __m256d t = _mm256_add_pd(_mm256_add_pd(v0, v1), _mm256_add_pd(v2, v3));
+        const __m128d s = _mm_add_pd(_mm256_castpd256_pd128(t), _mm256_extractf128_pd(t, 1));
+        double result = _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+
+        for (; i < size; ++i)
+            result += data[i];
+
+        return result;
+    }
+
+    __attribute__((target("avx2"))) StatKernels::MinMaxValues min_max_avx2(const double* data, size_t size)
+    {
+        if (size < 8)
+            return min_max_scalar(data, size);
+
+        __m256d min0 = _mm256_loadu_pd(data);
+        __m256d min1 = _mm256_loadu_pd(data + 4);
+        __m256d max0 = min0;
+        __m256d max1 = min1;
+
+        size_t i = 8;
+        for (; i + 8 <= size; i += 8)
+        {
+            const __m256d a = _mm256_loadu_pd(data + i);
+            const __m256d b = _mm256_loadu_pd(data + i + 4);
+            min0 = _mm256_min_pd(min0, a);
+            min1 = _mm256_min_pd(min1, b);
+            max0 = _mm256_max_pd(max0, a);
+            max1 = _mm256_max_pd(max1, b);
+        }
+
+        alignas(32) double mins[4];
+        alignas(32) double maxs[4];
+        _mm256_store_pd(mins, _mm256_min_pd(min0, min1));
+        _mm256_store_pd(maxs, _mm256_max_pd(max0, max1));
+
+        StatKernels::MinMaxValues result{*std::min_element(mins, mins + 4), *std::max_element(maxs, maxs + 4)};
+
+        for (; i < size; ++i)
+        {
+            result.min = std::min(result.min, data[i]);
+            result.max = std::max(result.max, data[i]);
+        }
+
+        return result;
+    }
+
+    bool cpu_has_avx2()
+    {
+        return __builtin_cpu_supports("avx2");
+    }
+#else
+    bool cpu_has_avx2()
+    {
+        return false;
+    }
+#endif
+
+    using SumBlockKernel = double (*)(const double*, size_t);
+    using MinMaxKernel = StatKernels::MinMaxValues (*)(const double*, size_t);
+
+    struct Kernels
+    {
+        bool avx2;
+        SumBlockKernel sum_block;
+        MinMaxKernel min_max;
+    };
+
+    const Kernels& kernels()
+    {
+#ifdef STAT_KERNELS_AVX2
+        static const Kernels selected = cpu_has_avx2()
+            ? Kernels{true, sum_block_avx2, min_max_avx2}
+            : Kernels{false, sum_block_scalar, min_max_scalar};
+#else
+        static const Kernels selected{false, sum_block_scalar, min_max_scalar};
+#endif
+        return selected;
+    }
+
+    double sum_pairwise(const double* data, size_t size, SumBlockKernel sum_block)
+    {
+        if (size <= pairwise_block)
+            return sum_block(data, size);
+
+        const size_t half = (size / 2) / lanes * lanes;
+        return sum_pairwise(data, half, sum_block) + sum_pairwise(data + half, size - half, sum_block);
+    }
+} // namespace
+
+namespace StatKernels
+{
+    double sum(const double* data, size_t size)
+    {
+        return sum_pairwise(data, size, kernels().sum_block);
+    }
+
+    MinMaxValues min_max(const double* data, size_t size)
+    {
+        return kernels().min_max(data, size);
+    }
+
+    bool uses_avx2()
+    {
+        return kernels().avx2;
+    }
+
+    namespace Scalar
+    {
+        double sum(const double* data, size_t size)
+        {
+            return sum_pairwise(data, size, sum_block_scalar);
+        }
+
+        MinMaxValues min_max(const double* data, size_t size)
+        {
+            return min_max_scalar(data, size);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef STAT_KERNELS_HPP
+#define STAT_KERNELS_HPP
+
+#include <cmath>
+#include <cstddef>
+
+// Vectorized building blocks for the statistics strategies.
+// AVX2 versions are selected at runtime when the CPU supports them; the scalar fallback
+// uses the same lane layout and reduction order, so both produce bit-identical results.
+namespace StatKernels
+{
+    struct MinMaxValues
+    {
+        double min;
+        double max;
+    };
+
+    // pairwise summation over 16 interleaved partial sums - error grows with log(size)
+    double sum(const double* data, size_t size);
+
+    // single pass for both values; size must be > 0
+    MinMaxValues min_max(const double* data, size_t size);
+
+    bool uses_avx2();
+
+    // the portable fallback kernels, whatever uses_avx2() says - results of sum & min_max
+    // must be bit-identical to them
+    namespace Scalar
+    {
+        double sum(const double* data, size_t size);
+        MinMaxValues min_max(const double* data, size_t size);
+    }
+
+    // precomputed per chunk of a column file
+    struct ChunkSummary
+    {
+        double min;
+        double max;
+        double sum;
+    };
+
+    // size must be > 0
+    inline ChunkSummary summarize(const double* data, size_t size)
+    {
+        const auto [min, max] = min_max(data, size);
+        return {min, max, sum(data, size)};
+    }
+
+    // Neumaier summation - used to combine partial sums of consecutive blocks
+    class CompensatedSum
+    {
+        double sum_{};
+        double compensation_{};
+
+    public:
+        void add(double value)
+        {
+            const double t = sum_ + value;
+            if (std::abs(sum_) >= std::abs(value))
+                compensation_ += (sum_ - t) + value;
+            else
+                compensation_ += (value - t) + sum_;
+            sum_ = t;
+        }
+
+        void merge(const CompensatedSum& other)
+        {
+            add(other.sum_);
+            compensation_ += other.compensation_;
+        }
+
+        double value() const
+        {
+            return sum_ + compensation_;
+        }
+    };
+}
+
+#endif // STAT_KERNELS_HPP
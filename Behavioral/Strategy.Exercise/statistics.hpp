@@ -0,0 +1,728 @@
+#ifndef STATISTICS_HPP
+#define STATISTICS_HPP
+
+#include "stat_kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Version_1
+{
+    struct StatResult
+    {
+        std::string description;
+        double value;
+
+        StatResult(const std::string& desc, double val)
+            : description(desc)
+            , value(val)
+        {
+        }
+    };
+
+    using Data = std::vector<double>;
+    using DataView = std::span<const double>; // owned Data or values mapped from a column file
+    using Results = std::vector<StatResult>;
+
+    // Per-element state of a statistic - fed with consecutive blocks of data
+    class Accumulator
+    {
+    public:
+        virtual ~Accumulator() = default;
+        virtual void update(const double* first, const double* last) = 0;
+        // chunk of a column file with precomputed summary - statistics that can be derived
+        // from the summary override it and never touch the values
+        virtual void update_chunk(const StatKernels::ChunkSummary& summary, const double* first, const double* last);
+        // other is always an accumulator of the same statistic, covering data that follows this one
+        virtual void merge(const Accumulator& other) = 0;
+        virtual void get_results(Results& results) const = 0;
+
+        // Copy constructed in storage of clone_size() bytes aligned like std::max_align_t and
+        // destroyed with std::destroy_at - lets many accumulators share one block of memory.
+        // clone_size() is 0 for accumulators that cannot be copied in place.
+        virtual size_t clone_size() const
+        {
+            return 0;
+        }
+
+        virtual Accumulator* clone_into(void*) const
+        {
+            return nullptr;
+        }
+    };
+
+    using AccumulatorPtr = std::unique_ptr<Accumulator>;
+
+    // size rounded up, so the next accumulator in a block is aligned
+    constexpr size_t aligned_clone_size(size_t size)
+    {
+        return (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    }
+
+    // CRTP - clone_into uses the copy constructor of TAccumulator
+    template <typename TAccumulator>
+    class CloneableAccumulator : public Accumulator
+    {
+    public:
+        size_t clone_size() const override
+        {
+            static_assert(alignof(TAccumulator) <= alignof(std::max_align_t));
+            return sizeof(TAccumulator);
+        }
+
+        Accumulator* clone_into(void* storage) const override
+        {
+            return ::new (storage) TAccumulator(static_cast<const TAccumulator&>(*this));
+        }
+    };
+
+    // Number of values passed to all accumulators before moving on - fits in L1 cache
+    constexpr size_t fused_block_size = 4096;
+
+    inline void accumulate(Accumulator& accumulator, const double* first, const double* last)
+    {
+        while (first != last)
+        {
+            const double* block_end = first + std::min<size_t>(fused_block_size, last - first);
+            accumulator.update(first, block_end);
+            first = block_end;
+        }
+    }
+
+    inline void accumulate(Accumulator& accumulator, DataView data)
+    {
+        accumulate(accumulator, data.data(), data.data() + data.size());
+    }
+
+    inline void Accumulator::update_chunk(const StatKernels::ChunkSummary&, const double* first, const double* last)
+    {
+        accumulate(*this, first, last);
+    }
+
+    // sequential and fused execution share the accumulator, so both give identical results
+    inline void calculate_with(Accumulator& accumulator, DataView data, Results& results)
+    {
+        accumulate(accumulator, data);
+        accumulator.get_results(results);
+    }
+
+    // value of a live series in a sliding window - index counts the values pushed so far
+    struct WindowSample
+    {
+        std::uint64_t index;
+        double timestamp;
+        double value;
+    };
+
+    // State of a statistic over a sliding window - samples are added at the back and
+    // evicted from the front in the same order, each in O(1) amortized
+    class WindowAccumulator
+    {
+    public:
+        virtual ~WindowAccumulator() = default;
+        virtual void add(const WindowSample& sample) = 0;
+        virtual void evict(const WindowSample& oldest) = 0;
+        // forgets all samples - the window adds the ones it keeps again
+        virtual void clear() = 0;
+        // results of an empty window are NaN, except for sums
+        virtual void get_results(Results& results) const = 0;
+    };
+
+    using WindowAccumulatorPtr = std::unique_ptr<WindowAccumulator>;
+
+    enum class ExecutionMode
+    {
+        sequential, // every statistic makes its own pass over the data
+        fused       // all accumulators are updated block by block in a single pass
+    };
+
+    class Statistics
+    {
+    public:
+        virtual ~Statistics() = default;
+        virtual void calculate(DataView data, Results& result) const = 0;
+
+        // whether a runner may compute the statistics with their accumulator instead of
+        // calculate() - a single statistic makes one pass over the data either way
+        virtual ExecutionMode execution_mode() const
+        {
+            return ExecutionMode::fused;
+        }
+
+        // statistics computable element by element return their accumulator, others nullptr
+        virtual AccumulatorPtr create_accumulator() const
+        {
+            return nullptr;
+        }
+
+        // statistics that can follow a sliding window return its state, others nullptr
+        virtual WindowAccumulatorPtr create_window_accumulator() const
+        {
+            return nullptr;
+        }
+    };
+
+    class Average : public Statistics
+    {
+    public:
+        class Accumulator : public CloneableAccumulator<Accumulator>
+        {
+            StatKernels::CompensatedSum sum_;
+            size_t count_{};
+
+        public:
+            void update(const double* first, const double* last) override
+            {
+                sum_.add(StatKernels::sum(first, last - first));
+                count_ += last - first;
+            }
+
+            void update_chunk(const StatKernels::ChunkSummary& summary, const double* first, const double* last) override
+            {
+                sum_.add(summary.sum);
+                count_ += last - first;
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                const auto& other_avg = static_cast<const Accumulator&>(other);
+                sum_.merge(other_avg.sum_);
+                count_ += other_avg.count_;
+            }
+
+            void get_results(Results& results) const override
+            {
+                results.push_back(StatResult("Avg", sum_.value() / count_));
+            }
+        };
+
+        class WindowAccumulator : public Version_1::WindowAccumulator
+        {
+            StatKernels::CompensatedSum sum_;
+            size_t count_{};
+
+        public:
+            void add(const WindowSample& sample) override
+            {
+                sum_.add(sample.value);
+                ++count_;
+            }
+
+            void evict(const WindowSample& oldest) override
+            {
+                sum_.add(-oldest.value);
+                --count_;
+            }
+
+            void clear() override
+            {
+                sum_ = {};
+                count_ = 0;
+            }
+
+            void get_results(Results& results) const override
+            {
+                results.push_back(StatResult("Avg", count_ ? sum_.value() / count_ : std::numeric_limits<double>::quiet_NaN()));
+            }
+        };
+
+        void calculate(DataView data, Results& results) const override
+        {
+            Accumulator accumulator;
+            calculate_with(accumulator, data, results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>();
+        }
+
+        Version_1::WindowAccumulatorPtr create_window_accumulator() const override
+        {
+            return std::make_unique<WindowAccumulator>();
+        }
+    };
+
+    class MinMax : public Statistics
+    {
+    public:
+        class Accumulator : public CloneableAccumulator<Accumulator>
+        {
+            double min_ = std::numeric_limits<double>::max();
+            double max_ = std::numeric_limits<double>::lowest();
+
+        public:
+            void update(const double* first, const double* last) override
+            {
+                if (first == last)
+                    return;
+
+                auto [min, max] = StatKernels::min_max(first, last - first);
+                min_ = std::min(min_, min);
+                max_ = std::max(max_, max);
+            }
+
+            void update_chunk(const StatKernels::ChunkSummary& summary, const double*, const double*) override
+            {
+                min_ = std::min(min_, summary.min);
+                max_ = std::max(max_, summary.max);
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                const auto& other_min_max = static_cast<const Accumulator&>(other);
+                min_ = std::min(min_, other_min_max.min_);
+                max_ = std::max(max_, other_min_max.max_);
+            }
+
+            void get_results(Results& results) const override
+            {
+                results.push_back(StatResult("Min", min_));
+                results.push_back(StatResult("Max", max_));
+            }
+        };
+
+        // monotonic deques - the front of each is the minimum or the maximum of the window
+        class WindowAccumulator : public Version_1::WindowAccumulator
+        {
+            std::deque<WindowSample> min_candidates_; // increasing values
+            std::deque<WindowSample> max_candidates_; // decreasing values
+
+        public:
+            void add(const WindowSample& sample) override
+            {
+                while (!min_candidates_.empty() && min_candidates_.back().value >= sample.value)
+                    min_candidates_.pop_back();
+                min_candidates_.push_back(sample);
+
+                while (!max_candidates_.empty() && max_candidates_.back().value <= sample.value)
+                    max_candidates_.pop_back();
+                max_candidates_.push_back(sample);
+            }
+
+            void evict(const WindowSample& oldest) override
+            {
+                if (!min_candidates_.empty() && min_candidates_.front().index == oldest.index)
+                    min_candidates_.pop_front();
+                if (!max_candidates_.empty() && max_candidates_.front().index == oldest.index)
+                    max_candidates_.pop_front();
+            }
+
+            void clear() override
+            {
+                min_candidates_.clear();
+                max_candidates_.clear();
+            }
+
+            void get_results(Results& results) const override
+            {
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                results.push_back(StatResult("Min", min_candidates_.empty() ? nan : min_candidates_.front().value));
+                results.push_back(StatResult("Max", max_candidates_.empty() ? nan : max_candidates_.front().value));
+            }
+        };
+
+        void calculate(DataView data, Results& results) const override
+        {
+            Accumulator accumulator;
+            calculate_with(accumulator, data, results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>();
+        }
+
+        Version_1::WindowAccumulatorPtr create_window_accumulator() const override
+        {
+            return std::make_unique<WindowAccumulator>();
+        }
+    };
+
+    class Sum : public Statistics
+    {
+    public:
+        class Accumulator : public CloneableAccumulator<Accumulator>
+        {
+            StatKernels::CompensatedSum sum_;
+
+        public:
+            void update(const double* first, const double* last) override
+            {
+                sum_.add(StatKernels::sum(first, last - first));
+            }
+
+            void update_chunk(const StatKernels::ChunkSummary& summary, const double*, const double*) override
+            {
+                sum_.add(summary.sum);
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                sum_.merge(static_cast<const Accumulator&>(other).sum_);
+            }
+
+            void get_results(Results& results) const override
+            {
+                results.push_back(StatResult("Sum", sum_.value()));
+            }
+        };
+
+        class WindowAccumulator : public Version_1::WindowAccumulator
+        {
+            StatKernels::CompensatedSum sum_;
+
+        public:
+            void add(const WindowSample& sample) override
+            {
+                sum_.add(sample.value);
+            }
+
+            void evict(const WindowSample& oldest) override
+            {
+                sum_.add(-oldest.value);
+            }
+
+            void clear() override
+            {
+                sum_ = {};
+            }
+
+            void get_results(Results& results) const override
+            {
+                results.push_back(StatResult("Sum", sum_.value()));
+            }
+        };
+
+        void calculate(DataView data, Results& results) const override
+        {
+            Accumulator accumulator;
+            calculate_with(accumulator, data, results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>();
+        }
+
+        Version_1::WindowAccumulatorPtr create_window_accumulator() const override
+        {
+            return std::make_unique<WindowAccumulator>();
+        }
+    };
+
+    // Sample variance & standard deviation - Welford's update generalized to blocks (Chan et al.):
+    // every block is reduced around its own mean, then merged into the running mean and M2
+    class Variance : public Statistics
+    {
+    public:
+        class Accumulator : public CloneableAccumulator<Accumulator>
+        {
+            size_t count_{};
+            double mean_{};
+            double m2_{};
+
+            void merge(size_t count, double mean, double m2)
+            {
+                const size_t total = count_ + count;
+                const double delta = mean - mean_;
+
+                mean_ += delta * count / total;
+                m2_ += m2 + delta * delta * (static_cast<double>(count_) * count / total);
+                count_ = total;
+            }
+
+        public:
+            void update(const double* first, const double* last) override
+            {
+                const size_t count = last - first;
+                if (count == 0)
+                    return;
+
+                const double mean = StatKernels::sum(first, count) / count;
+
+                double m2 = 0.0;
+                for (const double* it = first; it != last; ++it)
+                    m2 += (*it - mean) * (*it - mean);
+
+                merge(count, mean, m2);
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                const auto& other_var = static_cast<const Accumulator&>(other);
+                if (other_var.count_ != 0)
+                    merge(other_var.count_, other_var.mean_, other_var.m2_);
+            }
+
+            void get_results(Results& results) const override
+            {
+                const double variance = count_ > 1 ? m2_ / (count_ - 1) : std::numeric_limits<double>::quiet_NaN();
+                results.push_back(StatResult("Var", variance));
+                results.push_back(StatResult("StdDev", std::sqrt(variance)));
+            }
+        };
+
+        void calculate(DataView data, Results& results) const override
+        {
+            Accumulator accumulator;
+            calculate_with(accumulator, data, results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>();
+        }
+    };
+
+    class StatGroup : public Statistics
+    {
+        std::vector<std::shared_ptr<Statistics>> statistics_;
+        ExecutionMode mode_;
+
+    public:
+        // accumulators of the statistics of the group - the parts
+        class Accumulator : public Version_1::Accumulator
+        {
+        public:
+            void update(const double* first, const double* last) override
+            {
+                for (size_t i = 0; i < part_count(); ++i)
+                    part(i).update(first, last);
+            }
+
+            void update_chunk(const StatKernels::ChunkSummary& summary, const double* first, const double* last) override
+            {
+                for (size_t i = 0; i < part_count(); ++i)
+                    part(i).update_chunk(summary, first, last);
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                const auto& other_group = static_cast<const Accumulator&>(other);
+                for (size_t i = 0; i < part_count(); ++i)
+                    part(i).merge(other_group.part(i));
+            }
+
+            void get_results(Results& results) const override
+            {
+                for (size_t i = 0; i < part_count(); ++i)
+                    part(i).get_results(results);
+            }
+
+            // the copy and its parts take a single block - 0 when any part cannot be copied in place
+            size_t clone_size() const override
+            {
+                size_t size = PlacedAccumulator::parts_offset(part_count());
+                for (size_t i = 0; i < part_count(); ++i)
+                {
+                    const size_t part_size = part(i).clone_size();
+                    if (part_size == 0)
+                        return 0;
+                    size += aligned_clone_size(part_size);
+                }
+                return size;
+            }
+
+            Version_1::Accumulator* clone_into(void* storage) const override
+            {
+                return ::new (storage) PlacedAccumulator(*this, static_cast<std::byte*>(storage));
+            }
+
+            virtual size_t part_count() const = 0;
+            virtual Version_1::Accumulator& part(size_t index) const = 0;
+        };
+
+    private:
+        // made by create_accumulator() - parts allocated one by one
+        class OwningAccumulator : public Accumulator
+        {
+            std::vector<AccumulatorPtr> parts_;
+
+        public:
+            explicit OwningAccumulator(std::vector<AccumulatorPtr> parts)
+                : parts_{std::move(parts)}
+            {
+            }
+
+            size_t part_count() const override
+            {
+                return parts_.size();
+            }
+
+            Version_1::Accumulator& part(size_t index) const override
+            {
+                return *parts_[index];
+            }
+        };
+
+        // made by clone_into() - block layout: PlacedAccumulator, pointers to the parts, the parts
+        class PlacedAccumulator : public Accumulator
+        {
+            Version_1::Accumulator** parts_;
+            size_t part_count_{};
+
+        public:
+            static constexpr size_t parts_offset(size_t part_count)
+            {
+                return aligned_clone_size(sizeof(PlacedAccumulator)) + aligned_clone_size(part_count * sizeof(Version_1::Accumulator*));
+            }
+
+            PlacedAccumulator(const Accumulator& source, std::byte* block)
+                : parts_{reinterpret_cast<Version_1::Accumulator**>(block + aligned_clone_size(sizeof(PlacedAccumulator)))}
+            {
+                size_t offset = parts_offset(source.part_count());
+                try
+                {
+                    for (; part_count_ < source.part_count(); ++part_count_)
+                    {
+                        const Version_1::Accumulator& source_part = source.part(part_count_);
+                        ::new (parts_ + part_count_) Version_1::Accumulator*(source_part.clone_into(block + offset));
+                        offset += aligned_clone_size(source_part.clone_size());
+                    }
+                }
+                catch (...)
+                {
+                    destroy_parts();
+                    throw;
+                }
+            }
+
+            PlacedAccumulator(const PlacedAccumulator&) = delete;
+            PlacedAccumulator& operator=(const PlacedAccumulator&) = delete;
+
+            ~PlacedAccumulator() override
+            {
+                destroy_parts();
+            }
+
+            size_t part_count() const override
+            {
+                return part_count_;
+            }
+
+            Version_1::Accumulator& part(size_t index) const override
+            {
+                return *parts_[index];
+            }
+
+        private:
+            void destroy_parts()
+            {
+                for (size_t i = 0; i < part_count_; ++i)
+                    std::destroy_at(parts_[i]);
+            }
+        };
+
+    public:
+        StatGroup(std::initializer_list<std::shared_ptr<Statistics>> strategies, ExecutionMode mode = ExecutionMode::sequential)
+            : statistics_{strategies}
+            , mode_{mode}
+        {
+        }
+
+        void calculate(DataView data, Results& results) const override
+        {
+            if (mode_ == ExecutionMode::fused)
+            {
+                if (auto accumulator = create_accumulator())
+                {
+                    calculate_with(*accumulator, data, results);
+                    return;
+                }
+            }
+
+            for (const auto& stat : statistics_)
+            {
+                stat->calculate(data, results);
+            }
+        }
+
+        ExecutionMode execution_mode() const override
+        {
+            return mode_;
+        }
+
+        // nullptr when any of the statistics cannot be accumulated
+        AccumulatorPtr create_accumulator() const override
+        {
+            std::vector<AccumulatorPtr> accumulators;
+            accumulators.reserve(statistics_.size());
+
+            for (const auto& stat : statistics_)
+            {
+                auto accumulator = stat->create_accumulator();
+                if (!accumulator)
+                    return nullptr;
+                accumulators.push_back(std::move(accumulator));
+            }
+
+            return std::make_unique<OwningAccumulator>(std::move(accumulators));
+        }
+
+        // nullptr when any of the statistics cannot follow a sliding window
+        WindowAccumulatorPtr create_window_accumulator() const override
+        {
+            std::vector<WindowAccumulatorPtr> accumulators;
+            accumulators.reserve(statistics_.size());
+
+            for (const auto& stat : statistics_)
+            {
+                auto accumulator = stat->create_window_accumulator();
+                if (!accumulator)
+                    return nullptr;
+                accumulators.push_back(std::move(accumulator));
+            }
+
+            return std::make_unique<GroupWindowAccumulator>(std::move(accumulators));
+        }
+
+    private:
+        class GroupWindowAccumulator : public WindowAccumulator
+        {
+            std::vector<WindowAccumulatorPtr> parts_;
+
+        public:
+            explicit GroupWindowAccumulator(std::vector<WindowAccumulatorPtr> parts)
+                : parts_{std::move(parts)}
+            {
+            }
+
+            void add(const WindowSample& sample) override
+            {
+                for (const auto& part : parts_)
+                    part->add(sample);
+            }
+
+            void evict(const WindowSample& oldest) override
+            {
+                for (const auto& part : parts_)
+                    part->evict(oldest);
+            }
+
+            void clear() override
+            {
+                for (const auto& part : parts_)
+                    part->clear();
+            }
+
+            void get_results(Results& results) const override
+            {
+                for (const auto& part : parts_)
+                    part->get_results(results);
+            }
+        };
+    };
+}
+
+#endif // STATISTICS_HPP
@@ -0,0 +1,80 @@
+#ifndef STREAMING_STATISTICS_HPP
+#define STREAMING_STATISTICS_HPP
+
+#include "statistics.hpp"
+
+#include <istream>
+#include <stdexcept>
+#include <vector>
+
+namespace Version_1
+{
+    // Online mode - values are pushed one by one and reach the accumulator in blocks of
+    // fused_block_size, so memory use is constant and results can be read at any point
+    class StreamingStatistics
+    {
+        AccumulatorPtr accumulator_;
+        std::vector<double> buffer_;
+        size_t count_{};
+
+    public:
+        explicit StreamingStatistics(const Statistics& statistics)
+            : accumulator_{statistics.create_accumulator()}
+        {
+            if (!accumulator_)
+                throw std::invalid_argument("Statistics cannot be computed in streaming mode");
+
+            buffer_.reserve(fused_block_size);
+        }
+
+        void push(double value)
+        {
+            buffer_.push_back(value);
+            ++count_;
+
+            if (buffer_.size() == fused_block_size)
+                flush();
+        }
+
+        void push(const double* first, const double* last)
+        {
+            flush();
+            accumulate(*accumulator_, first, last);
+            count_ += last - first;
+        }
+
+        // reads whitespace separated values until the end of the stream
+        void push(std::istream& in)
+        {
+            double value;
+            while (in >> value)
+                push(value);
+        }
+
+        size_t count() const
+        {
+            return count_;
+        }
+
+        Results results()
+        {
+            flush();
+
+            Results results;
+            accumulator_->get_results(results);
+            return results;
+        }
+
+    private:
+        void flush()
+        {
+            if (buffer_.empty())
+                return;
+
+            accumulator_->update(buffer_.data(), buffer_.data() + buffer_.size());
+            buffer_.clear();
+        }
+    };
+}
+
+#endif // STREAMING_STATISTICS_HPP
@@ -0,0 +1,88 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+    std::vector<std::thread> threads_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex tasks_mtx_;
+    std::condition_variable tasks_cv_;
+    bool done_ = false;
+
+public:
+    explicit ThreadPool(size_t size = std::max(1u, std::thread::hardware_concurrency()))
+    {
+        threads_.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            threads_.emplace_back([this] { run(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lk{tasks_mtx_};
+            done_ = true;
+        }
+        tasks_cv_.notify_all();
+
+        for (auto& thd : threads_)
+            thd.join();
+    }
+
+    size_t size() const
+    {
+        return threads_.size();
+    }
+
+    template <typename Callable>
+    auto submit(Callable task) -> std::future<decltype(task())>
+    {
+        auto packaged_task = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+        auto result = packaged_task->get_future();
+
+        {
+            std::lock_guard lk{tasks_mtx_};
+            tasks_.push([packaged_task] { (*packaged_task)(); });
+        }
+        tasks_cv_.notify_one();
+
+        return result;
+    }
+
+private:
+    void run()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock lk{tasks_mtx_};
+                tasks_cv_.wait(lk, [this] { return done_ || !tasks_.empty(); });
+
+                if (tasks_.empty())
+                    return;
+
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+
+            task();
+        }
+    }
+};
+
+#endif // THREAD_POOL_HPP
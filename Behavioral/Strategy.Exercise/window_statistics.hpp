@@ -0,0 +1,234 @@
+#ifndef WINDOW_STATISTICS_HPP
+#define WINDOW_STATISTICS_HPP
+
+#include "statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+
+namespace Version_1
+{
+    // Statistics over the most recent values of a live series. Window-aware statistics -
+    // Average, MinMax, Sum and groups of them - are updated in O(1) amortized per value:
+    // min & max keep monotonic deques, sums are compensated running sums.
+    // A count-based window keeps the last size values; a time-based one the values whose
+    // timestamp is within duration of the newest timestamp. NaN values are ignored.
+    class SlidingWindow
+    {
+        enum class Kind
+        {
+            count,
+            time
+        };
+
+        Kind kind_;
+        size_t size_;
+        double duration_;
+
+        WindowAccumulatorPtr accumulator_;
+        std::deque<WindowSample> samples_;
+        size_t evicted_since_rebuild_{};
+        std::uint64_t next_index_{};
+
+        SlidingWindow(const Statistics& statistics, Kind kind, size_t size, double duration)
+            : kind_{kind}
+            , size_{size}
+            , duration_{duration}
+            , accumulator_{statistics.create_window_accumulator()}
+        {
+            if (!accumulator_)
+                throw std::invalid_argument("Statistics cannot be computed over a sliding window");
+        }
+
+    public:
+        static SlidingWindow count_based(const Statistics& statistics, size_t size)
+        {
+            if (size == 0)
+                throw std::invalid_argument("Window size must be positive");
+
+            return SlidingWindow{statistics, Kind::count, size, 0.0};
+        }
+
+        static SlidingWindow time_based(const Statistics& statistics, double duration)
+        {
+            if (!(duration > 0.0))
+                throw std::invalid_argument("Window duration must be positive");
+
+            return SlidingWindow{statistics, Kind::time, 0, duration};
+        }
+
+        // count-based windows only
+        void push(double value)
+        {
+            if (kind_ == Kind::time)
+                throw std::logic_error("Time-based window needs timestamps");
+
+            push(value, static_cast<double>(next_index_));
+        }
+
+        // timestamps must be finite; in a time-based window they must not decrease -
+        // a count-based window ignores them otherwise
+        void push(double value, double timestamp)
+        {
+            if (!std::isfinite(timestamp))
+                throw std::invalid_argument("Timestamps must be finite");
+
+            if (std::isnan(value))
+                return;
+
+            if (kind_ == Kind::time && !samples_.empty() && timestamp < samples_.back().timestamp)
+                throw std::invalid_argument("Timestamps must not decrease");
+
+            const WindowSample sample{next_index_++, timestamp, value};
+
+            samples_.push_back(sample);
+            accumulator_->add(sample);
+
+            evict();
+        }
+
+        void push(const double* first, const double* last)
+        {
+            for (; first != last; ++first)
+                push(*first);
+        }
+
+        // the values kept by later, which follow the values pushed to this window
+        void push(const SlidingWindow& later)
+        {
+            for (const auto& sample : later.samples_)
+                push(sample.value, sample.timestamp);
+        }
+
+        size_t size() const
+        {
+            return samples_.size();
+        }
+
+        bool empty() const
+        {
+            return samples_.empty();
+        }
+
+        void get_results(Results& results) const
+        {
+            accumulator_->get_results(results);
+        }
+
+        Results results() const
+        {
+            Results results;
+            get_results(results);
+            return results;
+        }
+
+    private:
+        bool expired(const WindowSample& sample) const
+        {
+            if (kind_ == Kind::count)
+                return samples_.size() > size_;
+
+            return sample.timestamp <= samples_.back().timestamp - duration_;
+        }
+
+        void evict()
+        {
+            // the newest value always stays - also when timestamp - duration rounds to timestamp
+            while (samples_.size() > 1 && expired(samples_.front()))
+            {
+                accumulator_->evict(samples_.front());
+                samples_.pop_front();
+                ++evicted_since_rebuild_;
+            }
+
+            // subtracting leaves rounding residue in the running sums - rebuilt once per
+            // window length, which keeps the cost O(1) amortized
+            if (evicted_since_rebuild_ > samples_.size())
+            {
+                accumulator_->clear();
+                for (const auto& sample : samples_)
+                    accumulator_->add(sample);
+                evicted_since_rebuild_ = 0;
+            }
+        }
+    };
+
+    // Window-aware statistics over the last size values of the data - a count-based
+    // SlidingWindow as a strategy for DataAnalyzer & StatGroup. Its accumulator keeps
+    // the window, so DataAnalyzer::append() costs O(1) amortized per value.
+    class WindowedStatistics : public Statistics
+    {
+        std::shared_ptr<Statistics> statistics_;
+        size_t size_;
+
+    public:
+        class Accumulator : public Version_1::Accumulator
+        {
+            SlidingWindow window_;
+
+        public:
+            explicit Accumulator(SlidingWindow window)
+                : window_{std::move(window)}
+            {
+            }
+
+            void update(const double* first, const double* last) override
+            {
+                window_.push(first, last);
+            }
+
+            void merge(const Version_1::Accumulator& other) override
+            {
+                window_.push(static_cast<const Accumulator&>(other).window_);
+            }
+
+            void get_results(Results& results) const override
+            {
+                window_.get_results(results);
+            }
+        };
+
+        // throws std::invalid_argument for size 0 or statistics that are not window-aware
+        WindowedStatistics(std::shared_ptr<Statistics> statistics, size_t size)
+            : statistics_{std::move(statistics)}
+            , size_{size}
+        {
+            make_window();
+        }
+
+        // only the tail of the data that ends up in the window is pushed
+        void calculate(DataView data, Results& results) const override
+        {
+            size_t first = data.size();
+            for (size_t kept = 0; first > 0 && kept < size_; --first)
+            {
+                if (!std::isnan(data[first - 1]))
+                    ++kept;
+            }
+
+            auto window = make_window();
+            window.push(data.data() + first, data.data() + data.size());
+            window.get_results(results);
+        }
+
+        AccumulatorPtr create_accumulator() const override
+        {
+            return std::make_unique<Accumulator>(make_window());
+        }
+
+    private:
+        SlidingWindow make_window() const
+        {
+            if (!statistics_)
+                throw std::invalid_argument("Windowed statistics need statistics");
+
+            return SlidingWindow::count_based(*statistics_, size_);
+        }
+    };
+}
+
+#endif // WINDOW_STATISTICS_HPP
@@ -0,0 +1,62 @@
+#include "column_stats.hpp"
+#include "data_parser.hpp"
+#include "report_builder.hpp"
+
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // text, integer & real columns - as in data_builder.txt with a salary column
+    std::vector<DataRow> generate_rows(size_t count)
+    {
+        std::vector<DataRow> rows;
+        rows.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            rows.push_back({"Jan", "Kowalski", "M", std::to_string(18 + i % 60), std::to_string(1000 + i % 997) + ".25"});
+        return rows;
+    }
+
+    void BM_RowAggregator_AddRow(benchmark::State& state)
+    {
+        const auto rows = generate_rows(state.range(0));
+
+        for (auto _ : state)
+        {
+            RowAggregator aggregator;
+            for (const auto& row : rows)
+                aggregator.add_row(row);
+            benchmark::DoNotOptimize(aggregator.columns().data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // the parse & build pass with & without the aggregate footer rows
+    void BM_DataParser_Aggregates(benchmark::State& state)
+    {
+        std::string data;
+        for (const auto& row : generate_rows(10'000))
+            data.append(row[0]).append(" ").append(row[1]).append(" ").append(row[2]).append(" ").append(row[3]).append(" ").append(row[4]).append("\n");
+
+        const bool with_aggregates = state.range(0) != 0;
+
+        for (auto _ : state)
+        {
+            std::istringstream in(data);
+            HtmlReportBuilder builder;
+            if (with_aggregates)
+                builder.set_aggregates({Aggregate::sum, Aggregate::min, Aggregate::max, Aggregate::mean});
+            DataParser parser(builder);
+            parser.Parse(in, "benchmark");
+            benchmark::DoNotOptimize(builder.get_report());
+        }
+
+        state.SetItemsProcessed(state.iterations() * 10'000);
+    }
+} // namespace
+
+BENCHMARK(BM_RowAggregator_AddRow)->Arg(10'000);
+BENCHMARK(BM_DataParser_Aggregates)->Arg(0)->Arg(1);
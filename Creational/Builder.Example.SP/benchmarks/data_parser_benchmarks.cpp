@@ -0,0 +1,111 @@
+#include "data_parser.hpp"
+#include "report_builder.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    // Same interface as ReportBuilder in Builder.Example - every call goes through the vtable
+    class VirtualReportBuilder
+    {
+    public:
+        virtual ~VirtualReportBuilder() = default;
+        virtual VirtualReportBuilder& add_header(const std::string& header_text) = 0;
+        virtual VirtualReportBuilder& begin_data() = 0;
+        virtual VirtualReportBuilder& add_row(const DataRow& data_row) = 0;
+        virtual VirtualReportBuilder& end_data() = 0;
+        virtual VirtualReportBuilder& add_footer(const std::string& footer) = 0;
+    };
+
+    // Wraps the static builders, so both paths do exactly the same work apart from dispatch
+    template <typename TReportBuilder>
+    class VirtualReportBuilderAdapter : public VirtualReportBuilder
+    {
+        TReportBuilder builder_;
+
+    public:
+        VirtualReportBuilder& add_header(const std::string& header_text) override
+        {
+            builder_.add_header(header_text);
+            return *this;
+        }
+
+        VirtualReportBuilder& begin_data() override
+        {
+            builder_.begin_data();
+            return *this;
+        }
+
+        VirtualReportBuilder& add_row(const DataRow& data_row) override
+        {
+            builder_.add_row(data_row);
+            return *this;
+        }
+
+        VirtualReportBuilder& end_data() override
+        {
+            builder_.end_data();
+            return *this;
+        }
+
+        VirtualReportBuilder& add_footer(const std::string& footer) override
+        {
+            builder_.add_footer(footer);
+            return *this;
+        }
+    };
+
+    std::string generate_data(size_t rows)
+    {
+        std::string data;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            data.append("Jan Kowalski M ").append(std::to_string(18 + i % 60)).append("\n");
+        }
+        return data;
+    }
+
+    template <typename TReportBuilder>
+    void BM_DataParser_StaticDispatch(benchmark::State& state)
+    {
+        const std::string data = generate_data(state.range(0));
+
+        for (auto _ : state)
+        {
+            std::istringstream in(data);
+            TReportBuilder builder;
+            DataParser parser(builder);
+            parser.Parse(in, "benchmark");
+            benchmark::DoNotOptimize(builder);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <typename TReportBuilder>
+    void BM_DataParser_VirtualDispatch(benchmark::State& state)
+    {
+        const std::string data = generate_data(state.range(0));
+
+        for (auto _ : state)
+        {
+            std::istringstream in(data);
+            std::unique_ptr<VirtualReportBuilder> builder = std::make_unique<VirtualReportBuilderAdapter<TReportBuilder>>();
+            benchmark::DoNotOptimize(builder.get()); // hides the dynamic type from the optimizer
+            DataParser parser(*builder);
+            parser.Parse(in, "benchmark");
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_DataParser_StaticDispatch, HtmlReportBuilder)->Arg(10'000);
+BENCHMARK_TEMPLATE(BM_DataParser_VirtualDispatch, HtmlReportBuilder)->Arg(10'000);
+BENCHMARK_TEMPLATE(BM_DataParser_StaticDispatch, CsvReportBuilder)->Arg(10'000);
+BENCHMARK_TEMPLATE(BM_DataParser_VirtualDispatch, CsvReportBuilder)->Arg(10'000);
@@ -0,0 +1,65 @@
+#include "html_escape.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace
+{
+    std::string make_cell(size_t length, bool with_special_chars)
+    {
+        std::string cell;
+        for (size_t i = 0; i < length; ++i)
+            cell.push_back(with_special_chars && i % 32 == 7 ? '<' : static_cast<char>('a' + i % 26));
+        return cell;
+    }
+
+    // reference point - plain copy of the cell into the document
+    void BM_AppendUnescaped(benchmark::State& state)
+    {
+        const std::string cell = make_cell(state.range(0), false);
+        std::string doc;
+
+        for (auto _ : state)
+        {
+            doc.clear();
+            doc.append(cell);
+            benchmark::DoNotOptimize(doc.data());
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_AppendHtmlEscaped_NoSpecialChars(benchmark::State& state)
+    {
+        const std::string cell = make_cell(state.range(0), false);
+        std::string doc;
+
+        for (auto _ : state)
+        {
+            doc.clear();
+            append_html_escaped(doc, cell);
+            benchmark::DoNotOptimize(doc.data());
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_AppendHtmlEscaped_WithSpecialChars(benchmark::State& state)
+    {
+        const std::string cell = make_cell(state.range(0), true);
+        std::string doc;
+
+        for (auto _ : state)
+        {
+            doc.clear();
+            append_html_escaped(doc, cell);
+            benchmark::DoNotOptimize(doc.data());
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+} // namespace
+
+BENCHMARK(BM_AppendUnescaped)->Arg(16)->Arg(256)->Arg(64 * 1024);
+BENCHMARK(BM_AppendHtmlEscaped_NoSpecialChars)->Arg(16)->Arg(256)->Arg(64 * 1024);
+BENCHMARK(BM_AppendHtmlEscaped_WithSpecialChars)->Arg(16)->Arg(256)->Arg(64 * 1024);
@@ -0,0 +1,171 @@
+#include "column_stats.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+using namespace std;
+
+std::string_view to_string(Aggregate aggregate)
+{
+    switch (aggregate)
+    {
+    case Aggregate::sum:
+        return "sum";
+    case Aggregate::min:
+        return "min";
+    case Aggregate::max:
+        return "max";
+    case Aggregate::mean:
+        return "mean";
+    }
+    return {};
+}
+
+namespace
+{
+    // from_chars accepts '-' but not '+' - a single leading '+' is skipped for both number kinds
+    string_view skip_plus(string_view cell)
+    {
+        if (cell.size() > 1 && cell.front() == '+' && cell[1] != '-' && cell[1] != '+')
+            cell.remove_prefix(1);
+        return cell;
+    }
+
+    bool parse_integer(string_view cell, double& value)
+    {
+        cell = skip_plus(cell);
+
+        long long integer{};
+        auto [ptr, ec] = from_chars(cell.data(), cell.data() + cell.size(), integer);
+        if (ec != errc{} || ptr != cell.data() + cell.size())
+            return false;
+
+        value = static_cast<double>(integer);
+        return true;
+    }
+
+    // "nan", "inf" & "infinity" (in any case) are parsed by from_chars - such cells are text
+    bool parse_real(string_view cell, double& value)
+    {
+        cell = skip_plus(cell);
+
+        auto [ptr, ec] = from_chars(cell.data(), cell.data() + cell.size(), value);
+        return ec == errc{} && ptr == cell.data() + cell.size() && std::isfinite(value);
+    }
+
+    string format_number(double value, bool integral)
+    {
+        char buffer[64];
+        to_chars_result result;
+
+        if (integral && std::abs(value) < 9.0e15) // exactly representable in long long
+            result = to_chars(begin(buffer), end(buffer), static_cast<long long>(value));
+        else
+            result = to_chars(begin(buffer), end(buffer), value);
+
+        return string(buffer, result.ptr);
+    }
+} // namespace
+
+void ColumnStats::add(std::string_view cell)
+{
+    if (type_ == ColumnType::text || cell.empty())
+        return;
+
+    double value{};
+
+    if (type_ != ColumnType::real && parse_integer(cell, value))
+    {
+        if (type_ == ColumnType::empty)
+            type_ = ColumnType::integer;
+    }
+    else if (parse_real(cell, value))
+    {
+        type_ = ColumnType::real;
+    }
+    else
+    {
+        type_ = ColumnType::text;
+        return;
+    }
+
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+std::optional<double> ColumnStats::value(Aggregate aggregate) const
+{
+    if (!is_numeric())
+        return std::nullopt;
+
+    switch (aggregate)
+    {
+    case Aggregate::sum:
+        return sum_;
+    case Aggregate::min:
+        return min_;
+    case Aggregate::max:
+        return max_;
+    case Aggregate::mean:
+        return sum_ / count_;
+    }
+
+    return std::nullopt;
+}
+
+std::string ColumnStats::format(Aggregate aggregate) const
+{
+    auto result = value(aggregate);
+    if (!result)
+        return {};
+
+    return format_number(*result, type_ == ColumnType::integer && aggregate != Aggregate::mean);
+}
+
+void RowAggregator::add_row(const DataRow& data_row)
+{
+    if (columns_.size() < data_row.size())
+        columns_.resize(data_row.size());
+
+    for (size_t i = 0; i < data_row.size(); ++i)
+        columns_[i].add(data_row[i]);
+}
+
+std::vector<ColumnType> RowAggregator::column_types() const
+{
+    std::vector<ColumnType> types;
+    types.reserve(columns_.size());
+    for (const auto& column : columns_)
+        types.push_back(column.type());
+
+    return types;
+}
+
+DataRow RowAggregator::aggregate_row(Aggregate aggregate) const
+{
+    DataRow row;
+    row.reserve(columns_.size());
+
+    bool labelled = false;
+    for (const auto& column : columns_)
+    {
+        if (column.is_numeric())
+        {
+            row.push_back(column.format(aggregate));
+        }
+        else if (!labelled)
+        {
+            row.emplace_back(to_string(aggregate));
+            labelled = true;
+        }
+        else
+        {
+            row.emplace_back();
+        }
+    }
+
+    return row;
+}
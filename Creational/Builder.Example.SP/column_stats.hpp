@@ -0,0 +1,89 @@
+#ifndef COLUMN_STATS_HPP
+#define COLUMN_STATS_HPP
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using DataRow = std::vector<std::string>;
+
+enum class ColumnType
+{
+    empty,
+    integer,
+    real,
+    text
+};
+
+enum class Aggregate
+{
+    sum,
+    min,
+    max,
+    mean
+};
+
+std::string_view to_string(Aggregate aggregate);
+
+// Detects the type of a column and keeps its running aggregates - every cell is parsed exactly once
+class ColumnStats
+{
+    ColumnType type_ = ColumnType::empty;
+    size_t count_ = 0;
+    double sum_ = 0.0;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+
+public:
+    void add(std::string_view cell);
+
+    ColumnType type() const
+    {
+        return type_;
+    }
+
+    bool is_numeric() const
+    {
+        return type_ == ColumnType::integer || type_ == ColumnType::real;
+    }
+
+    size_t count() const
+    {
+        return count_;
+    }
+
+    // std::nullopt for text and empty columns
+    std::optional<double> value(Aggregate aggregate) const;
+
+    // value formatted with std::to_chars - integer columns keep integral sum/min/max
+    std::string format(Aggregate aggregate) const;
+};
+
+class RowAggregator
+{
+    std::vector<ColumnStats> columns_;
+
+public:
+    void add_row(const DataRow& data_row);
+
+    void clear()
+    {
+        columns_.clear();
+    }
+
+    const std::vector<ColumnStats>& columns() const
+    {
+        return columns_;
+    }
+
+    std::vector<ColumnType> column_types() const;
+
+    // one cell per column: the aggregate for numeric columns, empty for the others;
+    // the first non-numeric column is labelled with the aggregate's name
+    DataRow aggregate_row(Aggregate aggregate) const;
+};
+
+#endif // COLUMN_STATS_HPP
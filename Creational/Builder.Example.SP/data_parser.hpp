@@ -4,45 +4,71 @@
 #include "report_builder.hpp"
 //#include <boost/algorithm/string.hpp>
 #include <fstream>
+#include <istream>
 #include <string>
-#include <sstream>
+#include <string_view>
 
-std::vector<std::string> split(const std::string& s, char delimiter)
+inline void split(std::string_view s, char delimiter, DataRow& tokens)
 {
-   std::vector<std::string> tokens;
-   std::string token;
-   std::istringstream tokenStream(s);
-   while (std::getline(tokenStream, token, delimiter))
-   {
-      tokens.push_back(token);
-   }
-   return tokens;
+    size_t count = 0;
+
+    for (size_t start = 0; start < s.size();)
+    {
+        size_t end = s.find(delimiter, start);
+        if (end == std::string_view::npos)
+            end = s.size();
+
+        auto token = s.substr(start, end - start);
+        if (count < tokens.size())
+            tokens[count].assign(token);
+        else
+            tokens.emplace_back(token);
+        ++count;
+
+        start = end + 1;
+    }
+
+    tokens.resize(count);
 }
 
-template <typename ReportBuilder>
+// Builder interface checked at compile time - no vtable, calls resolve statically
+template <typename T>
+concept ReportBuilder = requires(T& builder, const std::string& text, const DataRow& data_row) {
+    builder.add_header(text);
+    builder.begin_data();
+    builder.add_row(data_row);
+    builder.end_data();
+    builder.add_footer(text);
+};
+
+template <ReportBuilder TReportBuilder>
 class DataParser
 {
 public:
-    explicit DataParser(ReportBuilder& report_builder)
+    explicit DataParser(TReportBuilder& report_builder)
         : report_builder_(report_builder)
     {
     }
 
-    virtual void Parse(const std::string& file_name)
+    void Parse(const std::string& file_name)
     {
-        report_builder_.add_header(std::string("Raport from file: ") + file_name);
+        std::ifstream fin(file_name.c_str());
+        Parse(fin, file_name);
+    }
+
+    void Parse(std::istream& in, const std::string& source_name)
+    {
+        report_builder_.add_header(std::string("Raport from file: ") + source_name);
 
         report_builder_.begin_data();
 
-        std::ifstream fin(file_name.c_str());
+        std::string row;
+        DataRow data; // reused between rows - cells keep their capacity
 
-        while (!fin.eof())
+        while (std::getline(in, row))
         {
-            std::string row;
-            std::getline(fin, row);
+            split(row, ' ', data);
 
-            DataRow data = split(row, ' ');
-            
             //boost::split(data, row, boost::is_any_of(delimiters), boost::algorithm::token_compress_on);
 
             report_builder_.add_row(data);
@@ -53,18 +79,11 @@ public:
         report_builder_.add_footer("Copyright RaportBuilder 2013");
     }
 
-    DataParser(const DataParser&) = default;
-    DataParser& operator=(const DataParser&) = default;
-    DataParser(DataParser&&) = default;
-    DataParser& operator=(DataParser&&) = default;
-
-    virtual ~DataParser() = default;
-
 public:
-    ReportBuilder& report_builder_;
+    TReportBuilder& report_builder_;
 };
 
-template <typename ReportBuilder>
-DataParser(ReportBuilder) -> DataParser<ReportBuilder>;
+template <typename TReportBuilder>
+DataParser(TReportBuilder&) -> DataParser<TReportBuilder>;
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,99 @@
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "column_stats.hpp"
+
+using namespace ::testing;
+
+TEST(ColumnStats, IntegerColumnKeepsIntegralAggregates)
+{
+    ColumnStats column;
+    for (const char* cell : {"45", "23", "-7", "+10"})
+        column.add(cell);
+
+    ASSERT_EQ(column.type(), ColumnType::integer);
+    ASSERT_EQ(column.count(), 4u);
+    ASSERT_THAT(column.format(Aggregate::sum), StrEq("71"));
+    ASSERT_THAT(column.format(Aggregate::min), StrEq("-7"));
+    ASSERT_THAT(column.format(Aggregate::max), StrEq("45"));
+    ASSERT_THAT(column.format(Aggregate::mean), StrEq("17.75"));
+}
+
+TEST(ColumnStats, RealCellPromotesIntegerColumn)
+{
+    ColumnStats column;
+    column.add("1");
+    column.add("+2.5");
+
+    ASSERT_EQ(column.type(), ColumnType::real);
+    ASSERT_EQ(column.value(Aggregate::sum), 3.5);
+}
+
+TEST(ColumnStats, TextCellMakesColumnText)
+{
+    ColumnStats column;
+    column.add("1");
+    column.add("Kowalski");
+    column.add("2");
+
+    ASSERT_EQ(column.type(), ColumnType::text);
+    ASSERT_EQ(column.value(Aggregate::sum), std::nullopt);
+    ASSERT_THAT(column.format(Aggregate::sum), IsEmpty());
+}
+
+TEST(ColumnStats, NonFiniteSpellingsAreText)
+{
+    for (const char* cell : {"Nan", "nan", "Inf", "-inf", "INFINITY", "+inf"})
+    {
+        ColumnStats column;
+        column.add("1");
+        column.add(cell);
+
+        ASSERT_EQ(column.type(), ColumnType::text) << cell;
+    }
+}
+
+TEST(ColumnStats, LonePlusSignsAreText)
+{
+    for (const char* cell : {"+", "+-1", "++1"})
+    {
+        ColumnStats column;
+        column.add(cell);
+
+        ASSERT_EQ(column.type(), ColumnType::text) << cell;
+    }
+}
+
+TEST(ColumnStats, EmptyCellsAreSkipped)
+{
+    ColumnStats column;
+    column.add("");
+    ASSERT_EQ(column.type(), ColumnType::empty);
+
+    column.add("5");
+    column.add("");
+    ASSERT_EQ(column.type(), ColumnType::integer);
+    ASSERT_EQ(column.count(), 1u);
+}
+
+TEST(RowAggregator, AggregateRowLabelsFirstTextColumn)
+{
+    RowAggregator aggregator;
+    aggregator.add_row({"Jan", "Kowalski", "M", "45"});
+    aggregator.add_row({"Anna", "Nowak", "F", "23"});
+
+    ASSERT_THAT(aggregator.column_types(), ElementsAre(ColumnType::text, ColumnType::text, ColumnType::text, ColumnType::integer));
+    ASSERT_THAT(aggregator.aggregate_row(Aggregate::max), ElementsAre("max", "", "", "45"));
+    ASSERT_THAT(aggregator.aggregate_row(Aggregate::mean), ElementsAre("mean", "", "", "34"));
+}
+
+TEST(RowAggregator, ShortRowsLeaveMissingCellsOut)
+{
+    RowAggregator aggregator;
+    aggregator.add_row({"a", "1"});
+    aggregator.add_row({"b", "2", "3.5"});
+
+    ASSERT_THAT(aggregator.aggregate_row(Aggregate::sum), ElementsAre("sum", "3", "3.5"));
+}
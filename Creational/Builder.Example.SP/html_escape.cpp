@@ -0,0 +1,127 @@
+#include "html_escape.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HTML_ESCAPE_SSE2
+#endif
+
+namespace
+{
+    std::string_view entity(char c)
+    {
+        switch (c)
+        {
+        case '&':
+            return "&amp;";
+        case '<':
+            return "&lt;";
+        case '>':
+            return "&gt;";
+        case '"':
+            return "&quot;";
+        case '\'':
+            return "&#39;";
+        default:
+            return {};
+        }
+    }
+
+    bool needs_escaping(char c)
+    {
+        return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+    }
+
+    constexpr size_t block_size = 16;
+
+#ifdef HTML_ESCAPE_SSE2
+    // '"' is matched directly, (c | 1) == '\'' covers '&' and '\'', (c | 2) == '>' covers '<' and '>'
+    __m128i special_chars(const char* block)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+
+        const __m128i quot = _mm_cmpeq_epi8(chars, _mm_set1_epi8('"'));
+        const __m128i amp_apos = _mm_cmpeq_epi8(_mm_or_si128(chars, _mm_set1_epi8(1)), _mm_set1_epi8('\''));
+        const __m128i lt_gt = _mm_cmpeq_epi8(_mm_or_si128(chars, _mm_set1_epi8(2)), _mm_set1_epi8('>'));
+
+        return _mm_or_si128(quot, _mm_or_si128(amp_apos, lt_gt));
+    }
+
+    // bit i is set when block[i] needs escaping
+    uint32_t special_chars_mask(const char* block)
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(special_chars(block)));
+    }
+
+    bool has_special_chars_64(const char* block)
+    {
+        const __m128i matches = _mm_or_si128(
+            _mm_or_si128(special_chars(block), special_chars(block + 16)),
+            _mm_or_si128(special_chars(block + 32), special_chars(block + 48)));
+
+        return _mm_movemask_epi8(matches) != 0;
+    }
+#else
+    uint32_t special_chars_mask(const char* block)
+    {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < block_size; ++i)
+            mask |= static_cast<uint32_t>(needs_escaping(block[i])) << i;
+        return mask;
+    }
+
+    bool has_special_chars_64(const char* block)
+    {
+        for (size_t i = 0; i < 4 * block_size; ++i)
+            if (needs_escaping(block[i]))
+                return true;
+        return false;
+    }
+#endif
+} // namespace
+
+void append_html_escaped(std::string& out, std::string_view text)
+{
+    const char* const data = text.data();
+    const size_t size = text.size();
+
+    size_t run_start = 0;
+    size_t i = 0;
+
+    auto escape_block = [&](size_t block_start) {
+        for (uint32_t mask = special_chars_mask(data + block_start); mask != 0; mask &= mask - 1)
+        {
+            const size_t pos = block_start + std::countr_zero(mask);
+            out.append(data + run_start, pos - run_start);
+            out.append(entity(data[pos]));
+            run_start = pos + 1;
+        }
+    };
+
+    // clean 64-byte stretches are skipped with a single test
+    for (; i + 4 * block_size <= size; i += 4 * block_size)
+    {
+        if (has_special_chars_64(data + i))
+        {
+            for (size_t block = i; block < i + 4 * block_size; block += block_size)
+                escape_block(block);
+        }
+    }
+
+    for (; i + block_size <= size; i += block_size)
+        escape_block(i);
+
+    for (; i < size; ++i)
+    {
+        if (needs_escaping(data[i]))
+        {
+            out.append(data + run_start, i - run_start);
+            out.append(entity(data[i]));
+            run_start = i + 1;
+        }
+    }
+
+    out.append(data + run_start, size - run_start);
+}
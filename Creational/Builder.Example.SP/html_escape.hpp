@@ -0,0 +1,19 @@
+#ifndef HTML_ESCAPE_HPP
+#define HTML_ESCAPE_HPP
+
+#include <string>
+#include <string_view>
+
+// Appends text to out replacing & < > " ' with HTML entities.
+// Runs without special characters are copied in bulk.
+void append_html_escaped(std::string& out, std::string_view text);
+
+inline std::string html_escape(std::string_view text)
+{
+    std::string result;
+    result.reserve(text.size());
+    append_html_escaped(result, text);
+    return result;
+}
+
+#endif // HTML_ESCAPE_HPP
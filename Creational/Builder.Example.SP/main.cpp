@@ -10,6 +10,7 @@ constexpr auto file_name = "data_builder.txt";
 HtmlDocument build_html_document()
 {
     HtmlReportBuilder html_builder;
+    html_builder.set_aggregates({Aggregate::sum, Aggregate::min, Aggregate::max, Aggregate::mean});
     DataParser parser(html_builder);
     parser.Parse(file_name);
 
@@ -19,6 +20,7 @@ HtmlDocument build_html_document()
 CsvDocument build_csv_document()
 {
     CsvReportBuilder csv_builder;
+    csv_builder.set_aggregates({Aggregate::mean});
     DataParser parser(csv_builder);
     parser.Parse(file_name);
 
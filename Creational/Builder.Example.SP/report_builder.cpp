@@ -5,7 +5,10 @@ using namespace std;
 HtmlReportBuilder& HtmlReportBuilder::add_header(const std::string& header_text)
 {
     doc_.clear();
-    doc_.append("<h1>" + header_text + "</h1>\n");
+    aggregator_.clear();
+    doc_.append("<h1>");
+    append_html_escaped(doc_, header_text); // carries the source file name
+    doc_.append("</h1>\n");
 
     return *this;
 }
@@ -17,28 +20,31 @@ HtmlReportBuilder& HtmlReportBuilder::begin_data()
     return *this;
 }
 
-HtmlReportBuilder& HtmlReportBuilder::add_row(const DataRow& data_row)
+HtmlReportBuilder& HtmlReportBuilder::end_data()
 {
-    doc_.append("  <tr>\n");
-    for (const auto& item : data_row)
+    for (const auto aggregate : aggregates_)
     {
-        doc_.append("    <td>" + item + "</td>\n");
+        const std::string row_tag = "  <tr class='aggregate " + std::string(to_string(aggregate)) + "'>\n";
+        append_row(aggregator_.aggregate_row(aggregate), row_tag.c_str());
     }
-    doc_.append("  </tr>\n");
+
+    doc_.append("</table>\n");
 
     return *this;
 }
 
-HtmlReportBuilder& HtmlReportBuilder::end_data()
+HtmlReportBuilder& HtmlReportBuilder::add_footer(const std::string& footer)
 {
-    doc_.append("</table>\n");
+    doc_.append("<div class='footer'>");
+    append_html_escaped(doc_, footer);
+    doc_.append("</div>\n");
 
     return *this;
 }
 
-HtmlReportBuilder& HtmlReportBuilder::add_footer(const std::string& footer)
+HtmlReportBuilder& HtmlReportBuilder::set_aggregates(std::initializer_list<Aggregate> aggregates)
 {
-    doc_.append("<div class='footer'>" + footer + "</div>\n");
+    aggregates_.assign(aggregates);
 
     return *this;
 }
@@ -51,6 +57,7 @@ HtmlDocument HtmlReportBuilder::get_report()
 CsvReportBuilder& CsvReportBuilder::add_header(const std::string& header_text)
 {
     doc_.clear();
+    aggregator_.clear();
     doc_.push_back("# " + header_text);
 
     return *this;
@@ -63,30 +70,33 @@ CsvReportBuilder& CsvReportBuilder::begin_data()
     return *this;
 }
 
-CsvReportBuilder& CsvReportBuilder::add_row(const DataRow& data_row)
+CsvReportBuilder& CsvReportBuilder::end_data()
 {
-
-    string csv_row;
-
-    for (const auto& item : data_row)
+    for (const auto aggregate : aggregates_)
     {
-        csv_row.append(item + ";");
+        string csv_row;
+        for (const auto& item : aggregator_.aggregate_row(aggregate))
+        {
+            csv_row.append(item).append(1, ';');
+        }
+        doc_.push_back(std::move(csv_row));
     }
-    doc_.push_back(csv_row);
+
+    doc_.push_back("\n");
 
     return *this;
 }
 
-CsvReportBuilder& CsvReportBuilder::end_data()
+CsvReportBuilder& CsvReportBuilder::add_footer(const std::string& footer)
 {
-    doc_.push_back("\n");
+    doc_.push_back("# Summary: " + footer);
 
     return *this;
 }
 
-CsvReportBuilder& CsvReportBuilder::add_footer(const std::string& footer)
+CsvReportBuilder& CsvReportBuilder::set_aggregates(std::initializer_list<Aggregate> aggregates)
 {
-    doc_.push_back("# Summary: " + footer);
+    aggregates_.assign(aggregates);
 
     return *this;
 }
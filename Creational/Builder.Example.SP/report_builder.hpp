@@ -1,11 +1,14 @@
 #ifndef RAPORT_BUILDER_HPP
 #define RAPORT_BUILDER_HPP
 
+#include "column_stats.hpp"
+#include "html_escape.hpp"
+
+#include <initializer_list>
 #include <memory>
 #include <string>
 #include <vector>
 
-using DataRow = std::vector<std::string>;
 using HtmlDocument = std::string;
 using CsvDocument = std::vector<std::string>;
 
@@ -18,12 +21,47 @@ public:
     HtmlReportBuilder& end_data();
     HtmlReportBuilder& add_footer(const std::string& footer);
 
+    // requested aggregate rows are written by end_data() - columns are typed and aggregated as rows are added
+    HtmlReportBuilder& set_aggregates(std::initializer_list<Aggregate> aggregates);
+
+    const RowAggregator& aggregator() const
+    {
+        return aggregator_;
+    }
+
     HtmlDocument get_report();
 
 private:
     HtmlDocument doc_;
+    std::vector<Aggregate> aggregates_;
+    RowAggregator aggregator_;
+
+    void append_row(const DataRow& data_row, const char* row_tag);
 };
 
+// add_row is called once per parsed line - defined inline so it can be expanded in DataParser::Parse
+inline HtmlReportBuilder& HtmlReportBuilder::add_row(const DataRow& data_row)
+{
+    if (!aggregates_.empty())
+        aggregator_.add_row(data_row);
+
+    append_row(data_row, "  <tr>\n");
+
+    return *this;
+}
+
+inline void HtmlReportBuilder::append_row(const DataRow& data_row, const char* row_tag)
+{
+    doc_.append(row_tag);
+    for (const auto& item : data_row)
+    {
+        doc_.append("    <td>");
+        append_html_escaped(doc_, item);
+        doc_.append("</td>\n");
+    }
+    doc_.append("  </tr>\n");
+}
+
 class CsvReportBuilder 
 {
 public:
@@ -33,10 +71,36 @@ public:
     CsvReportBuilder& end_data();
     CsvReportBuilder& add_footer(const std::string& footer);
 
+    // requested aggregate rows are written by end_data() - columns are typed and aggregated as rows are added
+    CsvReportBuilder& set_aggregates(std::initializer_list<Aggregate> aggregates);
+
+    const RowAggregator& aggregator() const
+    {
+        return aggregator_;
+    }
+
     CsvDocument get_report();
 
 private:
     CsvDocument doc_;
+    std::vector<Aggregate> aggregates_;
+    RowAggregator aggregator_;
 };
 
+inline CsvReportBuilder& CsvReportBuilder::add_row(const DataRow& data_row)
+{
+    if (!aggregates_.empty())
+        aggregator_.add_row(data_row);
+
+    std::string csv_row;
+
+    for (const auto& item : data_row)
+    {
+        csv_row.append(item).append(1, ';');
+    }
+    doc_.push_back(std::move(csv_row));
+
+    return *this;
+}
+
 #endif // RAPORT_BUILDER_HPP